@@ -14,21 +14,12 @@ colour colourLerp(colour a, colour b, float t) {
     };
 }
 
-#define GRADIENT_STOP_COUNT 5
-const colour GRADIENT_STOPS[GRADIENT_STOP_COUNT] = {
-    { 50, 50, 255 }, // Blue
-    { 50, 255, 50 }, // Green
-    { 255, 255, 50 }, // Yellow
-    { 255, 50, 50 }, // Red
-    { 50, 50, 255 } // Loop back to Blue
-};
-
 // Get a colour from the gradient based on the iteration count
-colour colourGradient(unsigned int iteration, unsigned int maxIterations) {
-    int num_stops = GRADIENT_STOP_COUNT - 1;
+colour colourGradient(unsigned int iteration, unsigned int maxIterations, const colourScheme& scheme) {
+    int num_stops = (int)scheme.stops.size() - 1;
 
     // Normalise the iteration count within the gradient range
-    float gradient_position = fmodf(iteration / (float)maxIterations, 1.0f) * num_stops;
+    float gradient_position = fmodf(iteration / (float)maxIterations + scheme.cycleOffset, 1.0f) * num_stops;
 
     // Determine the two stops to interpolate between
     int stop_prev = (int)floorf(gradient_position);
@@ -38,5 +29,32 @@ colour colourGradient(unsigned int iteration, unsigned int maxIterations) {
     float stop_fraction = gradient_position - stop_prev;
 
     // Lerp between the two stops
-    return colourLerp(GRADIENT_STOPS[stop_prev], GRADIENT_STOPS[stop_next], stop_fraction);
+    return colourLerp(scheme.stops[stop_prev], scheme.stops[stop_next], stop_fraction);
+}
+
+// Blend two packed 32 bit colours by t / 256, each byte is a channel so the pixel format doesn't matter
+unsigned int lerpPackedColour(unsigned int a, unsigned int b, unsigned int t) {
+    unsigned int evenBytes = ((a & 0x00FF00FF) * (256 - t) + (b & 0x00FF00FF) * t) >> 8;
+    unsigned int oddBytes = ((a >> 8) & 0x00FF00FF) * (256 - t) + ((b >> 8) & 0x00FF00FF) * t;
+    return (evenBytes & 0x00FF00FF) | (oddBytes & 0xFF00FF00);
+}
+
+// Average of packed 32 bit colours, byte by byte like lerpPackedColour
+unsigned int averagePackedColours(const unsigned int* colours, unsigned int count) {
+    unsigned int sums[4] = { 0, 0, 0, 0 };
+    for (unsigned int i = 0; i < count; i++) {
+        for (unsigned int byte = 0; byte < 4; byte++)
+            sums[byte] += (colours[i] >> (byte * 8)) & 0xFF;
+    }
+
+    unsigned int average = 0;
+    for (unsigned int byte = 0; byte < 4; byte++)
+        average |= (sums[byte] / count) << (byte * 8);
+
+    return average;
+}
+
+// Get a colour from the distance to the fractal boundary, measured in pixels
+colour colourDistance(float pixelDistance) {
+    return colourLerp(BLACK, WHITE, sqrtf(fminf(pixelDistance / DISTANCE_SHADE_WIDTH, 1.0f)));
 }
\ No newline at end of file
@@ -1,15 +1,29 @@
 #ifndef COLOUR_H
 #define COLOUR_H
 
+#include <vector>
+
 struct colour {
     unsigned char r;
     unsigned char g;
     unsigned char b;
 };
 
+// How samples are mapped to colours, kept apart from the samples so it can change without rerendering
+struct colourScheme {
+    const std::vector<colour>& stops; // Gradient stops, the last should match the first so the gradient loops
+    float cycleOffset; // Fraction of the gradient the colours are shifted along by
+};
+
 colour colourLerp(colour a, colour b, float t);
-colour colourGradient(unsigned int iteration, unsigned int maxIterations);
+colour colourGradient(unsigned int iteration, unsigned int maxIterations, const colourScheme& scheme);
+colour colourDistance(float pixelDistance);
+unsigned int lerpPackedColour(unsigned int a, unsigned int b, unsigned int t);
+unsigned int averagePackedColours(const unsigned int* colours, unsigned int count);
 
 const colour BLACK = colour{ 0, 0, 0 };
+const colour WHITE = colour{ 255, 255, 255 };
+
+const float DISTANCE_SHADE_WIDTH = 2.0f; // Distance in pixels over which boundary lines fade out
 
 #endif
\ No newline at end of file
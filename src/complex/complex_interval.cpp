@@ -0,0 +1,41 @@
+#include "complex_interval.hpp"
+
+// Constructors
+ComplexInterval::ComplexInterval() : re(0.0), im(0.0) {}
+ComplexInterval::ComplexInterval(const Complex& z) : re(z.real()), im(z.imag()) {}
+ComplexInterval::ComplexInterval(const Interval& real, const Interval& imag) : re(real), im(imag) {}
+
+// Getters
+Interval ComplexInterval::real() const { return re; }
+Interval ComplexInterval::imag() const { return im; }
+
+// Complex interval arithmetic operators
+ComplexInterval ComplexInterval::operator+(const ComplexInterval& w) const {
+    return ComplexInterval(re + w.re, im + w.im);
+}
+
+ComplexInterval ComplexInterval::operator-(const ComplexInterval& w) const {
+    return ComplexInterval(re - w.re, im - w.im);
+}
+
+ComplexInterval ComplexInterval::operator*(const ComplexInterval& w) const {
+    return ComplexInterval(re * w.re - im * w.im, re * w.im + im * w.re);
+}
+
+// Mathmatical operations
+ComplexInterval ComplexInterval::sqr(const ComplexInterval& z) {
+    // (x + iy)^2 = x^2 - y^2 + 2ixy, squaring each part separately keeps the bounds tight
+    return ComplexInterval(Interval::sqr(z.re) - Interval::sqr(z.im), z.re * z.im * Interval(2.0));
+}
+
+ComplexInterval ComplexInterval::conj(const ComplexInterval& z) {
+    return ComplexInterval(z.re, -z.im);
+}
+
+Interval ComplexInterval::magSq(const ComplexInterval& z) {
+    return Interval::sqr(z.re) + Interval::sqr(z.im);
+}
+
+bool ComplexInterval::contains(const ComplexInterval& outer, const ComplexInterval& inner) {
+    return Interval::contains(outer.re, inner.re) && Interval::contains(outer.im, inner.im);
+}
@@ -0,0 +1,35 @@
+#ifndef COMPLEX_INTERVAL_H
+#define COMPLEX_INTERVAL_H
+
+#include "complex.hpp"
+#include "interval.hpp"
+
+// Rectangle of complex numbers, used to iterate a whole region of c values at once
+class ComplexInterval {
+    private:
+        Interval re;
+        Interval im;
+
+    public:
+        // Constructors
+        ComplexInterval();
+        ComplexInterval(const Complex& z);
+        ComplexInterval(const Interval& real, const Interval& imag);
+
+        // Getters
+        Interval real() const;
+        Interval imag() const;
+
+        // Complex interval arithmetic operators
+        ComplexInterval operator+(const ComplexInterval& w) const;
+        ComplexInterval operator-(const ComplexInterval& w) const;
+        ComplexInterval operator*(const ComplexInterval& w) const;
+
+        // Mathmatical operations
+        static ComplexInterval sqr(const ComplexInterval& z);
+        static ComplexInterval conj(const ComplexInterval& z);
+        static Interval magSq(const ComplexInterval& z);
+        static bool contains(const ComplexInterval& outer, const ComplexInterval& inner);
+};
+
+#endif
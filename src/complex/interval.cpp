@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cmath>
+
+#include "interval.hpp"
+
+// Widen bounds by one ulp, enough to cover round-to-nearest error
+static Interval roundOutward(long double lower, long double upper) {
+    return Interval(std::nextafter(lower, -INFINITY), std::nextafter(upper, INFINITY));
+}
+
+// Constructors
+Interval::Interval() : lo(0.0), hi(0.0) {}
+Interval::Interval(const long double& value) : lo(value), hi(value) {}
+Interval::Interval(const long double& lower, const long double& upper) : lo(lower), hi(upper) {}
+
+// Getters
+long double Interval::lower() const { return lo; }
+long double Interval::upper() const { return hi; }
+
+// Interval arithmetic operators
+Interval Interval::operator+(const Interval& w) const {
+    return roundOutward(lo + w.lo, hi + w.hi);
+}
+
+Interval Interval::operator-(const Interval& w) const {
+    return roundOutward(lo - w.hi, hi - w.lo);
+}
+
+Interval Interval::operator*(const Interval& w) const {
+    long double a = lo * w.lo;
+    long double b = lo * w.hi;
+    long double c = hi * w.lo;
+    long double d = hi * w.hi;
+
+    return roundOutward(std::min({ a, b, c, d }), std::max({ a, b, c, d }));
+}
+
+Interval Interval::operator-() const {
+    return Interval(-hi, -lo);
+}
+
+// Mathmatical operations
+Interval Interval::sqr(const Interval& x) {
+    // Tighter than x * x since both factors are the same value
+    if (x.lo >= 0)
+        return roundOutward(x.lo * x.lo, x.hi * x.hi);
+    if (x.hi <= 0)
+        return roundOutward(x.hi * x.hi, x.lo * x.lo);
+
+    return Interval(0.0, std::nextafter(std::max(x.lo * x.lo, x.hi * x.hi), INFINITY));
+}
+
+Interval Interval::abs(const Interval& x) {
+    if (x.lo >= 0)
+        return x;
+    if (x.hi <= 0)
+        return -x;
+
+    return Interval(0.0, std::max(-x.lo, x.hi));
+}
+
+bool Interval::contains(const Interval& outer, const Interval& inner) {
+    return outer.lo <= inner.lo && inner.hi <= outer.hi;
+}
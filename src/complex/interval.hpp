@@ -0,0 +1,32 @@
+#ifndef INTERVAL_H
+#define INTERVAL_H
+
+// Closed interval of reals, every operation rounds its bounds outwards so the true result is always enclosed
+class Interval {
+    private:
+        long double lo;
+        long double hi;
+
+    public:
+        // Constructors
+        Interval();
+        Interval(const long double& value);
+        Interval(const long double& lower, const long double& upper);
+
+        // Getters
+        long double lower() const;
+        long double upper() const;
+
+        // Interval arithmetic operators
+        Interval operator+(const Interval& w) const;
+        Interval operator-(const Interval& w) const;
+        Interval operator*(const Interval& w) const;
+        Interval operator-() const;
+
+        // Mathmatical operations
+        static Interval sqr(const Interval& x);
+        static Interval abs(const Interval& x);
+        static bool contains(const Interval& outer, const Interval& inner);
+};
+
+#endif
@@ -1,10 +1,11 @@
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <filesystem>
 #include <functional>
 #include <iostream>
 #include <regex>
 #include <string>
-#include <thread>
 
 #include <SDL2/SDL_image.h>
 
@@ -30,6 +31,21 @@ const unsigned int INITIAL_ITERATIONS = 96;
 const unsigned int ITERATION_INCREMENT = 40;
 const unsigned int MAX_ITERATIONS_LIMIT = 10000;
 
+const float BUDGET_UNFINISHED_SHARE = 0.001f; // Share of pixels that may reach the limit, or escape in the top half of it, before it is raised
+const float BUDGET_ESCAPE_PERCENTILE = 0.999f; // Share of escaped pixels the limit must comfortably cover
+const unsigned int BUDGET_HEADROOM = 2; // Multiple of that escape iteration to allow, as deeper views escape later
+
+const float THROUGHPUT_SMOOTHING = 0.5f; // Weight of the latest render in the throughput average
+
+const unsigned int IDLE_REFINE_DELAY = 250; // Milliseconds without input before the view starts being refined
+const unsigned int IDLE_ANTI_ALIAS_GRID = 3;
+const unsigned int MAX_ANTI_ALIAS_GRID = 4; // Largest grid of the anti-aliasing options
+
+const int PROGRESS_REDRAW_INTERVAL = 50; // Milliseconds between redraws of the progress bar while rendering
+const unsigned int INPUT_REDRAW_FRAMES = 2; // ImGui acts on input in the first frame and shows the result in the next
+
+const unsigned int MIN_COLOUR_LOOKUP_SIZE = 256; // Covers samples that aren't iterations, like Newton roots, at low limits
+
 const std::string IMAGE_PATH = "./saved_images";
 
 const ImGuiWindowFlags BASE_WINDOW_FLAGS =
@@ -41,8 +57,16 @@ ImGuiWindowFlags_NoNav;
 FractalRenderer::FractalRenderer(unsigned int width, unsigned int height)
     : winWidth(width), winHeight(height),
     halfWinWidth(width / 2.0), halfWinHeight(height / 2.0),
+    iterationBudget(0),
     isRecalculatingFractal(false),
-    cancelRender(false)
+    cancelRender(false),
+    renderCancelled([this]() { return cancelRender.load(); }),
+    redrawRequested(false),
+    renderThroughput(0.0),
+    pixelCost(0.0),
+    finishedRefinement(refinement::NONE),
+    finishedScaleFactor(1.0f),
+    finishedMaxIterations(0)
 {
     // Setup SDL
     if (SDL_Init(SDL_INIT_VIDEO)) {
@@ -58,6 +82,11 @@ FractalRenderer::FractalRenderer(unsigned int width, unsigned int height)
     }
     SDL_SetWindowMinimumSize(window, MIN_WIN_WIDTH, MIN_WIN_HEIGHT);
 
+    // Lets render threads wake the main loop, which falls back to redrawing on a timer while rendering without it
+    redrawEventType = SDL_RegisterEvents(1);
+    if (redrawEventType == (Uint32)-1)
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't register redraw event: %s", SDL_GetError());
+
     refreshFractalSize();
 
     renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
@@ -75,12 +104,34 @@ FractalRenderer::FractalRenderer(unsigned int width, unsigned int height)
     ImGui_ImplSDL2_InitForSDLRenderer(window, renderer);
     ImGui_ImplSDLRenderer2_Init(renderer);
 
+    displayFormat = SDL_AllocFormat(SDL_PIXELFORMAT_RGBA32);
+    if (displayFormat == nullptr) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't allocate pixel format: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+
     curFractalIdx = 0;
     fractalOptions = {
-        { "Mandelbrot Set", SDLK_1, processMandelbrot, calcTrajectoryMandelbrot },
-        { "Tricorn", SDLK_2, processTricorn, calcTrajectoryTricorn },
-        { "Burning Ship", SDLK_3, processBurningShip, calcTrajectoryBurningShip },
-        { "Newton Fractal", SDLK_4, processNewtonFractal, calcTrajectoryNewtonFractal }
+        { "Mandelbrot Set", SDLK_1, processMandelbrot, colourEscapeTime, calcTrajectoryMandelbrot, true, estimateDistanceMandelbrot, classifyMandelbrotTile, mirrorSameSample },
+        { "Tricorn", SDLK_2, processTricorn, colourEscapeTime, calcTrajectoryTricorn, true, nullptr, classifyTricornTile, mirrorSameSample },
+        { "Burning Ship", SDLK_3, processBurningShip, colourEscapeTime, calcTrajectoryBurningShip, true, nullptr, classifyBurningShipTile, nullptr },
+        { "Newton Fractal", SDLK_4, processNewtonFractal, colourNewtonFractal, calcTrajectoryNewtonFractal, false, nullptr, nullptr, mirrorNewtonFractalSample }
+    };
+
+    curAntiAliasIdx = 0;
+    antiAliasOptions = {
+        { "Off", 0 },
+        { "2x2", 2 },
+        { "3x3", 3 },
+        { "4x4", 4 },
+    };
+
+    curPaletteIdx = 0;
+    paletteOptions = {
+        { "Rainbow", { { 50, 50, 255 }, { 50, 255, 50 }, { 255, 255, 50 }, { 255, 50, 50 }, { 50, 50, 255 } } },
+        { "Fire", { { 90, 10, 10 }, { 230, 80, 20 }, { 255, 200, 50 }, { 255, 255, 200 }, { 90, 10, 10 } } },
+        { "Ocean", { { 10, 30, 90 }, { 30, 120, 200 }, { 120, 220, 240 }, { 240, 255, 255 }, { 10, 30, 90 } } },
+        { "Greyscale", { { 40, 40, 40 }, { 255, 255, 255 }, { 40, 40, 40 } } },
     };
 
     curResolutionIdx = 0;
@@ -91,6 +142,16 @@ FractalRenderer::FractalRenderer(unsigned int width, unsigned int height)
         { "12.5%", std::sqrt(0.125f) },
         { "6.25%", 0.25f },
     };
+
+    curRenderModeIdx = 0;
+    renderModeOptions = {
+        { "Standard", renderMode::STANDARD },
+        { "Progressive", renderMode::PROGRESSIVE },
+        { "Solid Guessing", renderMode::SOLID_GUESSING },
+        { "Boundary Tracing", renderMode::BOUNDARY_TRACING },
+        { "Distance Estimation", renderMode::DISTANCE_ESTIMATION },
+        { "Certified Tiles", renderMode::CERTIFIED_TILES },
+    };
 }
 
 FractalRenderer::~FractalRenderer() {
@@ -116,28 +177,68 @@ FractalRenderer::~FractalRenderer() {
         fractalTexture = nullptr;
     }
 
-    if (fractalTextureBuffer) {
-        SDL_DestroyTexture(fractalTextureBuffer);
-        fractalTextureBuffer = nullptr;
-    }
-
     if (trajectoryTexture) {
         SDL_DestroyTexture(trajectoryTexture);
         trajectoryTexture = nullptr;
     }
 
+    if (displayFormat) {
+        SDL_FreeFormat(displayFormat);
+        displayFormat = nullptr;
+    }
+
     pixelDataBuffer.clear();
+    pixelFractionBuffer.clear();
+    displaySamples.clear();
+    displayFractions.clear();
+    displayBuffer.clear();
+    frameCache.clear();
 
     SDL_Quit();
 }
 
+// Sleep until there is something new to draw, rather than drawing the same frame every vsync
+void FractalRenderer::waitForEvents() {
+    // Frames are still waiting to be drawn, or colour cycling changes the frame every vsync
+    if (pendingFrames > 0 || cycleColours)
+        return;
+
+    int timeout = -1; // Wait indefinitely
+    unsigned long long int idleTicks = SDL_GetTicks64() - lastInputTicks;
+    bool rendering = isRecalculatingFractal;
+
+    if (rendering)
+        timeout = PROGRESS_REDRAW_INTERVAL;
+    else if ((refineWhenIdle || dynamicResolution) && idleTicks < IDLE_REFINE_DELAY)
+        timeout = (int)(IDLE_REFINE_DELAY - idleTicks); // Wake up to start refining
+
+    // Leaves the event queued for handleEvents
+    SDL_WaitEventTimeout(nullptr, timeout);
+
+    // Keep the progress bar moving
+    if (rendering)
+        pendingFrames = 1;
+}
+
 void FractalRenderer::handleEvents() {
     SDL_Event event;
     SDL_Keycode eventKey;
     int mx, my;
 
     while (SDL_PollEvent(&event)) {
+        pendingFrames = INPUT_REDRAW_FRAMES;
+
+        // Only asks for the new samples to be drawn, so isn't input
+        if (event.type == redrawEventType) {
+            redrawRequested = false;
+            continue;
+        }
+
         ImGui_ImplSDL2_ProcessEvent(&event);
+        lastInputTicks = SDL_GetTicks64();
+
+        // Refinement runs on every core, so it gives way to any input straight away and resumes once idle again
+        cancelRefinement();
 
         ImGuiIO& io = ImGui::GetIO();
         bool mouseInImGui = io.WantCaptureMouse;
@@ -157,8 +258,11 @@ void FractalRenderer::handleEvents() {
                     // Set centre of screen at the point clicked
                     SDL_GetMouseState(&mx, &my);
 
-                    Complex c = screenToFractal(mx, my, halfWinWidth, halfWinHeight, fractalWidthRatio, fractalHeightRatio, offsetX, offsetY);
-                    setFractalOffset((long double)c.real(), (long double)c.imag());
+                    // Move by whole pixels, the centre lies between pixels on an odd window size and samples would stop lining up
+                    setFractalOffset(
+                        offsetX + std::round(mx - halfWinWidth) * fractalWidthRatio,
+                        offsetY + std::round(halfWinHeight - my) * fractalHeightRatio
+                    );
 
                     beginAsyncRendering();
                 }
@@ -189,7 +293,19 @@ void FractalRenderer::handleEvents() {
                     if (zoomPower < 0)
                         break;
 
+                    double oldWidthRatio = fractalWidthRatio;
+                    double oldHeightRatio = fractalHeightRatio;
                     setZoomLevel(zoomPower);
+
+                    // Zoom about the pixel nearest the centre, so every other sample stays on the old frame's samples
+                    // even when the centre lies between pixels on an odd window size
+                    long double centreX = std::floor(halfWinWidth);
+                    long double centreY = std::floor(halfWinHeight);
+                    setFractalOffset(
+                        offsetX + (centreX - halfWinWidth) * (oldWidthRatio - fractalWidthRatio),
+                        offsetY + (halfWinHeight - centreY) * (oldHeightRatio - fractalHeightRatio)
+                    );
+
                     beginAsyncRendering();
                 }
                 break;
@@ -215,7 +331,12 @@ void FractalRenderer::handleEvents() {
                         resetToInitialFractal();
                     }
                     else if (eventKey == SDLK_s) {
-                        if (curResolutionIdx != 0) // Doesn't work at lower resolutions
+                        // Doesn't work at lower resolutions
+                        int textureWidth = 0, textureHeight = 0;
+                        if (fractalTexture)
+                            SDL_QueryTexture(fractalTexture, nullptr, nullptr, &textureWidth, &textureHeight);
+
+                        if (textureWidth != (int)winWidth || textureHeight != (int)winHeight)
                             break;
                             
                         // Save snapshot of the window
@@ -260,10 +381,6 @@ void FractalRenderer::setWindowSize(unsigned int width, unsigned int height) {
 
     SDL_RenderSetLogicalSize(renderer, winWidth, winHeight);
 
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
-    SDL_RenderPresent(renderer);
-
     destroyTrajectory = true;
 
     refreshFractalSize();
@@ -294,6 +411,7 @@ void FractalRenderer::resetToInitialFractal() {
     numZooms = 0;
     offsetX = INITIAL_OFFSET_X;
     offsetY = INITIAL_OFFSET_Y;
+    iterationBudget = 0;
 
     destroyTrajectory = true;
 
@@ -322,10 +440,27 @@ void FractalRenderer::setZoomLevel(long double zoomPower) {
 }
 
 void FractalRenderer::selectResolution(unsigned int resolutionIndex) {
-    if (resolutionIndex == curResolutionIdx)
+    if (resolutionIndex == curResolutionIdx && !dynamicResolution)
         return;
 
     curResolutionIdx = resolutionIndex;
+    dynamicResolution = false;
+    beginAsyncRendering();
+}
+
+void FractalRenderer::selectRenderMode(unsigned int renderModeIndex) {
+    if (renderModeIndex == curRenderModeIdx)
+        return;
+
+    curRenderModeIdx = renderModeIndex;
+    beginAsyncRendering();
+}
+
+void FractalRenderer::selectAntiAliasing(unsigned int antiAliasIndex) {
+    if (antiAliasIndex == curAntiAliasIdx)
+        return;
+
+    curAntiAliasIdx = antiAliasIndex;
     beginAsyncRendering();
 }
 
@@ -334,12 +469,22 @@ void FractalRenderer::selectFractal(unsigned int fractalIndex) {
         return;
 
     curFractalIdx = fractalIndex;
+    iterationBudget = 0;
     destroyTrajectory = true;
 
     beginAsyncRendering();
 }
 
-void FractalRenderer::beginAsyncRendering(bool fullRender) {
+// Palettes only change how samples are coloured, so the current render is recoloured rather than redone
+void FractalRenderer::selectPalette(unsigned int paletteIndex) {
+    if (paletteIndex == curPaletteIdx)
+        return;
+
+    curPaletteIdx = paletteIndex;
+    recolourDisplay = true;
+}
+
+void FractalRenderer::beginAsyncRendering(bool fullRender, refinement level) {
     if (isRecalculatingFractal) {
         cancelRender = true;
         if (renderingTask.valid())
@@ -349,98 +494,447 @@ void FractalRenderer::beginAsyncRendering(bool fullRender) {
     }
 
     isRecalculatingFractal = true;
+    renderingRefinement = level;
+
+    // Set max iterations based on render mode, previews follow the last render's budget once there is one
+    if (fullRender || level >= refinement::ITERATIONS)
+        curMaxIterations = maxIterations;
+    else if (adaptiveIterations && iterationBudget > 0)
+        curMaxIterations = std::min<unsigned int>(iterationBudget, maxIterations);
+    else
+        curMaxIterations = calculateIterations(numZooms, INITIAL_ITERATIONS, ITERATION_INCREMENT, maxIterations);
+
+    renderMode mode = renderModeOptions[curRenderModeIdx].mode;
+
+    // Throughput measured on another fractal or mode is in other units, so is measured again
+    if (curFractalIdx != throughputFractalIdx || mode != throughputMode) {
+        renderThroughput = 0.0;
+        throughputFractalIdx = curFractalIdx;
+        throughputMode = mode;
+    }
 
     // Calculate render size based off resolution
-    float lengthScaleFactor = resolutionOptions[curResolutionIdx].lengthScaleFactor;
+    float lengthScaleFactor = level >= refinement::RESOLUTION ? 1.0f : resolutionOptions[previewResolutionIdx()].lengthScaleFactor;
     unsigned int renderWidth = (int)(winWidth * lengthScaleFactor);
     unsigned int renderHeight = (int)(winHeight * lengthScaleFactor);
 
     pixelDataBuffer.resize((unsigned long long int)renderWidth * renderHeight, 0);
+    pixelFractionBuffer.resize(pixelDataBuffer.size(), 0);
+
+    // Distance shading depends on the pixel spacing as well as the point, so can't be mixed with escape iterations
+    bool distanceShaded = mode == renderMode::DISTANCE_ESTIMATION && fractalOptions[curFractalIdx].distanceFunc;
+
+    renderJob job = {
+        fractalOptions[curFractalIdx].func,
+        distanceShaded ? colourDistanceSample : fractalOptions[curFractalIdx].colourFunc,
+        !distanceShaded,
+        fractalOptions[curFractalIdx].escapeTime,
+        fractalOptions[curFractalIdx].distanceFunc,
+        fractalOptions[curFractalIdx].tileFunc,
+        fractalOptions[curFractalIdx].mirrorSample,
+        curMaxIterations,
+        lengthScaleFactor,
+        renderWidth, renderHeight,
+        halfWinWidth, halfWinHeight,
+        fractalWidthRatio, fractalHeightRatio,
+        offsetX, offsetY,
+        fractalWidthRatio / lengthScaleFactor,
+        level >= refinement::ANTI_ALIASING ? std::max(antiAliasOptions[curAntiAliasIdx].grid, IDLE_ANTI_ALIAS_GRID) : antiAliasOptions[curAntiAliasIdx].grid,
+        antiAliasBudget,
+        mode,
+        solidGuessSafeTinyTiles,
+        smoothColours,
+        {},
+        {},
+        {}
+    };
+
+    if (useSymmetry)
+        job.mirrorRows = mirroredRows(job);
 
     renderProgress = 0;
-    renderMaxProgress = renderWidth;
+    renderMaxProgress = 0;
+    if (mode == renderMode::PROGRESSIVE) {
+        for (const progressivePass& pass : PROGRESSIVE_PASSES)
+            renderMaxProgress += renderWidth > pass.startX ? (renderWidth - pass.startX + pass.stepX - 1) / pass.stepX : 0;
+    }
+    else if (mode == renderMode::SOLID_GUESSING && job.escapeTime)
+        renderMaxProgress = solidGuessingTileCount(renderWidth, renderHeight);
+    else if (mode == renderMode::BOUNDARY_TRACING && job.escapeTime)
+        renderMaxProgress = boundaryTracingTileCount(renderWidth, renderHeight);
+    else if (mode == renderMode::DISTANCE_ESTIMATION && job.distanceFunc)
+        renderMaxProgress = distanceEstimationTileCount(renderWidth, renderHeight);
+    else if (mode == renderMode::CERTIFIED_TILES && job.tileFunc)
+        renderMaxProgress = certifiedTileCount(renderWidth, renderHeight);
+    else
+        renderMaxProgress = renderWidth;
+
+    renderingTask = std::async(std::launch::async, [this, job, mode, distanceShaded, level, fractalIdx = curFractalIdx, dynamic = dynamicResolution]() mutable {
+        auto renderStart = std::chrono::steady_clock::now();
+        unfinishedOrbits.clear();
+        subsamples = {};
+        pixelFlags.assign(pixelDataBuffer.size(), 0);
+        reuseCachedFrames(job, fractalIdx, distanceShaded);
+
+        // Modes that rely on escape-time behaviour fall back to a standard render for other fractals
+        if (mode == renderMode::PROGRESSIVE)
+            renderProgressive(job);
+        else if (mode == renderMode::SOLID_GUESSING && job.escapeTime)
+            renderSolidGuessing(job);
+        else if (mode == renderMode::BOUNDARY_TRACING && job.escapeTime)
+            renderBoundaryTracing(job);
+        else if (mode == renderMode::DISTANCE_ESTIMATION && job.distanceFunc)
+            renderDistanceEstimation(job);
+        else if (mode == renderMode::CERTIFIED_TILES && job.tileFunc)
+            renderCertifiedTiles(job);
+        else
+            renderStandard(job);
+
+        // Distance shading is already smooth, and its samples can't be averaged through the colour lookup
+        if (job.antiAliasGrid > 0 && job.colourLookup && !cancelRender)
+            renderAntiAliasing(job);
+
+        // Renders are cancelled on every resize event while dragging, keep what they finished so the next one carries on
+        storeFrame(job, fractalIdx, distanceShaded, !cancelRender);
+        double renderTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - renderStart).count();
+
+        if (cancelRender)
+            return;
+
+        // Refined renders use the set limit rather than a preview's, so say nothing about the next preview
+        if (job.escapeTime && !distanceShaded && level == refinement::NONE)
+            updateIterationBudget(job);
+
+        if (dynamic && level == refinement::NONE)
+            updateDynamicResolution(job, renderTime);
 
-    // Set up fractal texture buffer
-    if (fractalTextureBuffer)
-        SDL_DestroyTexture(fractalTextureBuffer);
+        finishedRefinement = level;
+        finishedScaleFactor = job.lengthScaleFactor;
+        finishedMaxIterations = job.maxIterations;
+        isRecalculatingFractal = false;
+        requestRedraw();
+    });
+}
 
-    fractalTextureBuffer = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, renderWidth, renderHeight);
-    if (fractalTextureBuffer == nullptr) {
-        SDL_Log("Failed to create texture: %s", SDL_GetError());
+// Stop a refinement in progress, what it finished is cached and it starts again once the user is idle
+void FractalRenderer::cancelRefinement() {
+    if (!isRecalculatingFractal || renderingRefinement == refinement::NONE)
         return;
-    }
 
-    auto fractalFuncCopy = fractalOptions[curFractalIdx].func;
+    cancelRender = true;
+    if (renderingTask.valid())
+        renderingTask.wait();
 
-    renderingTask = std::async(std::launch::async, [this, fullRender, fractalFuncCopy, lengthScaleFactor, renderWidth, renderHeight]() {
-        int numThreads = std::thread::hardware_concurrency();
-        std::vector<std::thread> threads;
-        int sectionWidth = renderWidth / numThreads;
+    cancelRender = false;
+    isRecalculatingFractal = false;
+}
 
-        // Set max iterations based on render mode
-        curMaxIterations = fullRender ? maxIterations : calculateIterations(numZooms, INITIAL_ITERATIONS, ITERATION_INCREMENT, maxIterations);
+// Turn idle time into image quality, refining the finished view one step at a time
+// Renders started by input cancel the refinement in progress, like any other render
+void FractalRenderer::refineWhileIdle() {
+    // Dynamic resolution always brings the view back up to full resolution
+    if ((!refineWhenIdle && !dynamicResolution) || isRecalculatingFractal || SDL_GetTicks64() - lastInputTicks < IDLE_REFINE_DELAY)
+        return;
 
-        SDL_PixelFormat* pixelFormat = SDL_AllocFormat(SDL_PIXELFORMAT_RGBA32);
-        if (pixelFormat == nullptr) {
-            SDL_Log("Failed to allocate pixel format: %s", SDL_GetError());
+    // Skip steps that wouldn't change the image
+    auto changesImage = [this](refinement level) {
+        switch (level) {
+            case refinement::ITERATIONS:
+                return refineWhenIdle && finishedMaxIterations < maxIterations;
+            case refinement::RESOLUTION:
+                return finishedScaleFactor < 1.0f;
+            case refinement::ANTI_ALIASING:
+                // Distance shading isn't anti-aliased
+                return refineWhenIdle && antiAliasOptions[curAntiAliasIdx].grid < IDLE_ANTI_ALIAS_GRID &&
+                    !(renderModeOptions[curRenderModeIdx].mode == renderMode::DISTANCE_ESTIMATION && fractalOptions[curFractalIdx].distanceFunc);
+            default:
+                return false;
+        }
+    };
+
+    refinement level = finishedRefinement;
+    while (level != refinement::ANTI_ALIASING) {
+        level = (refinement)((int)level + 1);
+
+        if (changesImage(level)) {
+            beginAsyncRendering(false, level);
             return;
         }
+    }
+}
 
-        // Create a thread for each vertical slice
-        for (int i = 0; i < numThreads; ++i) {
-            int startX = i * sectionWidth;
-            int endX = (i == numThreads - 1) ? renderWidth : (i + 1) * sectionWidth;
+// Set the next render's limit from this one's escape iterations, raising it while too many pixels reach the limit
+// and otherwise fitting it to where the escapes tail off
+void FractalRenderer::updateIterationBudget(const renderJob& job) {
+    std::vector<unsigned int> histogram(job.maxIterations, 0);
+    unsigned long long int unfinished = 0;
+    unsigned long long int escaped = 0;
+    unsigned long long int lateEscapes = 0;
+
+    for (unsigned int sample : pixelDataBuffer) {
+        if (sample < job.maxIterations) {
+            histogram[sample]++;
+            escaped++;
+            lateEscapes += sample >= job.maxIterations / 2;
+        }
+        else if (sample == SAMPLE_UNFINISHED)
+            unfinished++;
+    }
 
-            threads.emplace_back(std::thread([this, startX, endX, fractalFuncCopy, pixelFormat, lengthScaleFactor, renderWidth, renderHeight]() {
-                for (int x = startX; x < endX; x++) {
-                    for (int y = 0; y < renderHeight; y++) {
-                        if (cancelRender)
-                            return;
+    // Unfinished pixels are only worth more iterations while pixels are still escaping close to the limit,
+    // otherwise they are most likely interior points the periodicity check hasn't caught
+    unsigned long long int threshold = pixelDataBuffer.size() * BUDGET_UNFINISHED_SHARE;
+    if (unfinished > threshold && lateEscapes > threshold) {
+        iterationBudget = std::min(job.maxIterations * 2, MAX_ITERATIONS_LIMIT);
+        return;
+    }
 
-                        Complex c = screenToFractal(x / lengthScaleFactor, y / lengthScaleFactor, halfWinWidth, halfWinHeight, fractalWidthRatio, fractalHeightRatio, offsetX, offsetY);
-                        colour col = fractalFuncCopy(c, curMaxIterations);
+    // Nothing escaped, so there is no tail to fit to
+    if (escaped == 0)
+        return;
 
-                        std::lock_guard<std::mutex> lock(renderMutex);
-                        if (y < renderHeight && x < renderWidth)
-                            pixelDataBuffer[(unsigned long long int)y * renderWidth + x] = SDL_MapRGB(pixelFormat, col.r, col.g, col.b);
-                    }
+    unsigned long long int covered = 0;
+    unsigned int tail = 0;
+    while (tail < job.maxIterations && covered < escaped * BUDGET_ESCAPE_PERCENTILE)
+        covered += histogram[tail++];
 
-                    renderProgress++;
-                }
-            }));
+    iterationBudget = std::clamp(tail * BUDGET_HEADROOM, INITIAL_ITERATIONS, MAX_ITERATIONS_LIMIT);
+}
+
+// Measure how fast renders get through iterations, and how many iterations this view's pixels take, for dynamic resolution
+void FractalRenderer::updateDynamicResolution(const renderJob& job, double renderTime) {
+    // Escape iterations are the work done, other samples don't say how long they took so count once
+    bool iterationSamples = job.escapeTime && job.colourLookup;
+    auto sampleCost = [&](unsigned int sample) {
+        if (!iterationSamples)
+            return 1.0;
+
+        return sample < job.maxIterations ? sample + 1.0 : (double)job.maxIterations;
+    };
+
+    unsigned long long int computed = 0;
+    double work = 0.0;
+    for (unsigned long long int i = 0; i < pixelDataBuffer.size(); i++) {
+        if (pixelFlags[i] & PIXEL_COMPUTED) {
+            computed++;
+            work += sampleCost(pixelDataBuffer[i]);
         }
+    }
+
+    for (unsigned int sample : subsamples.samples) {
+        computed++;
+        work += sampleCost(sample);
+    }
 
-        // Wait for all threads to finish
-        for (auto& t : threads)
-            if (t.joinable())
-                t.join();
+    // Frames taken entirely from the cache or proven by certified tiles say nothing about the throughput
+    if (computed == 0 || renderTime <= 0.0)
+        return;
 
-        SDL_FreeFormat(pixelFormat);
+    double throughput = work / renderTime;
+    if (renderThroughput == 0.0)
+        renderThroughput = throughput;
+    else
+        renderThroughput = renderThroughput + THROUGHPUT_SMOOTHING * (throughput - renderThroughput);
 
-        if (cancelRender)
-            return;
+    pixelCost = work / computed;
+}
 
-        // Update fractal texture
-        {
-            std::lock_guard<std::mutex> lock(renderMutex);
+// Resolution of renders before they are refined, with dynamic resolution the highest one expected to render the whole
+// window within the target frame time, sticking to the listed ones so cached frames still line up
+unsigned int FractalRenderer::previewResolutionIdx() {
+    if (!dynamicResolution)
+        return curResolutionIdx;
 
-            void* pixels;
-            int pitch;
+    // Nothing measured yet
+    if (renderThroughput == 0.0)
+        return 0;
 
-            if (SDL_LockTexture(fractalTextureBuffer, nullptr, &pixels, &pitch) < 0) {
-                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Couldn't lock fractal texture buffer: %s", SDL_GetError());
-                return;
-            }
+    double windowWork = (double)winWidth * winHeight * pixelCost;
+    float lengthScaleFactor = (float)std::sqrt(targetFrameTime * renderThroughput / windowWork);
 
-            memcpy(pixels, pixelDataBuffer.data(), pixelDataBuffer.size() * sizeof(unsigned int));
+    unsigned int resolutionIdx = 0;
+    while (resolutionIdx + 1 < resolutionOptions.size() && resolutionOptions[resolutionIdx].lengthScaleFactor > lengthScaleFactor)
+        resolutionIdx++;
+
+    return resolutionIdx;
+}
 
-            SDL_UnlockTexture(fractalTextureBuffer);
+// Hand the samples to the main thread to be coloured, pixels not computed yet copy the sample at the top left of their block
+void FractalRenderer::publishPixelData(const renderJob& job, unsigned int blockWidth, unsigned int blockHeight) {
+    std::lock_guard<std::mutex> lock(renderMutex);
 
-            std::swap(fractalTexture, fractalTextureBuffer);
+    displaySamples.resize(pixelDataBuffer.size());
+    displayFractions.resize(pixelDataBuffer.size());
+
+    for (unsigned int y = 0; y < job.height; y++) {
+        unsigned long long int sampleRow = (unsigned long long int)(y - y % blockHeight) * job.width;
+        unsigned long long int row = (unsigned long long int)y * job.width;
+
+        for (unsigned int x = 0; x < job.width; x++) {
+            displaySamples[row + x] = pixelDataBuffer[sampleRow + x - x % blockWidth];
+            displayFractions[row + x] = pixelFractionBuffer[sampleRow + x - x % blockWidth];
         }
+    }
 
-        isRecalculatingFractal = false;
-    });
+    displaySubsamples = subsamples;
+    displayColourFunc = job.colourFunc;
+    displayMaxIterations = job.maxIterations;
+    displayColourLookup = job.colourLookup;
+    displayEscapeTime = job.escapeTime;
+    displayWidth = job.width;
+    displayHeight = job.height;
+    displayEqualisedStale = true;
+    displayBufferDirty = true;
+
+    requestRedraw();
+}
+
+// Wake the main loop from a render thread, at most one redraw event is queued at a time
+void FractalRenderer::requestRedraw() {
+    if (redrawEventType == (Uint32)-1 || redrawRequested.exchange(true))
+        return;
+
+    SDL_Event event = {};
+    event.type = redrawEventType;
+    if (SDL_PushEvent(&event) <= 0)
+        redrawRequested = false;
+}
+
+// Colour the published samples with the current palette
+// This runs on the main thread every frame while cycling, so it colours serially rather than starting threads that
+// would compete with the render's, a table lookup per pixel is cheap enough for that
+void FractalRenderer::colourDisplay() {
+    displayBuffer.resize(displaySamples.size());
+
+    colourScheme scheme = { paletteOptions[curPaletteIdx].stops, colourCycleOffset };
+
+    auto packColour = [this, &scheme](unsigned int sample) {
+        colour col = displayColourFunc(sample, displayMaxIterations, scheme);
+        return SDL_MapRGB(displayFormat, col.r, col.g, col.b);
+    };
+
+    if (!displayColourLookup) {
+        for (unsigned long long int i = 0; i < displaySamples.size(); i++)
+            displayBuffer[i] = packColour(displaySamples[i]);
+
+        return;
+    }
+
+    bool equalise = equaliseColours && displayEscapeTime;
+    if (equalise && displayEqualisedStale) {
+        displayEqualised = equaliseIterations();
+        displayEqualisedStale = false;
+    }
+
+    // Colouring the table costs one call per iteration rather than one per pixel, every sample at or above the limit shares the last entry
+    unsigned int lookupSize = std::max(displayMaxIterations, MIN_COLOUR_LOOKUP_SIZE);
+    colourLookupTable.resize(lookupSize + 1);
+    for (unsigned int i = 0; i < lookupSize; i++)
+        colourLookupTable[i] = packColour(equalise && i < displayEqualised.size() ? displayEqualised[i] : i);
+    colourLookupTable[lookupSize] = packColour(SAMPLE_INTERIOR);
+
+    bool smooth = smoothColours && displayEscapeTime;
+    unsigned int lastIteration = displayMaxIterations - 1;
+
+    // Escaped pixels blend towards the next iteration's colour by their escape fraction
+    auto lookupColour = [this, lookupSize, lastIteration](unsigned int sample, unsigned char fraction) {
+        const unsigned int* table = colourLookupTable.data();
+        if (sample < displayMaxIterations)
+            return lerpPackedColour(table[sample], table[std::min(sample + 1, lastIteration)], fraction);
+
+        return table[std::min(sample, lookupSize)];
+    };
+
+    if (smooth) {
+        for (unsigned long long int i = 0; i < displaySamples.size(); i++)
+            displayBuffer[i] = lookupColour(displaySamples[i], displayFractions[i]);
+    }
+    else {
+        // A plain clamped gather, which the compiler can vectorise
+        const unsigned int* samples = displaySamples.data();
+        unsigned int* pixels = displayBuffer.data();
+        const unsigned int* table = colourLookupTable.data();
+
+        for (unsigned long long int i = 0; i < displaySamples.size(); i++)
+            pixels[i] = table[std::min(samples[i], lookupSize)];
+    }
+
+    // Supersampled pixels take the average colour of their subsamples
+    const subsampleTable& table = displaySubsamples;
+    unsigned int samplesPerPixel = table.grid * table.grid;
+
+    std::array<unsigned int, MAX_ANTI_ALIAS_GRID * MAX_ANTI_ALIAS_GRID> colours;
+
+    for (unsigned long long int i = 0; i < table.pixels.size(); i++) {
+        for (unsigned int k = 0; k < samplesPerPixel; k++) {
+            unsigned long long int subsample = i * samplesPerPixel + k;
+            colours[k] = lookupColour(table.samples[subsample], smooth ? table.fractions[subsample] : 0);
+        }
+
+        displayBuffer[table.pixels[i]] = averagePackedColours(colours.data(), samplesPerPixel);
+    }
+}
+
+// Map each escape iteration to its share of the escaped pixels, so the gradient is spread evenly over the pixels rather than the iterations
+// Only depends on the samples, so is worked out on the first recolour that equalises each published set rather than every recolour
+std::vector<unsigned int> FractalRenderer::equaliseIterations() {
+    std::vector<unsigned int> histogram(displayMaxIterations, 0);
+    unsigned long long int escaped = 0;
+
+    for (unsigned int sample : displaySamples) {
+        if (sample < displayMaxIterations) {
+            histogram[sample]++;
+            escaped++;
+        }
+    }
+
+    if (escaped == 0)
+        return {};
+
+    // Each iteration moves to the fraction of escaped pixels that escaped before it
+    std::vector<unsigned int> equalised(displayMaxIterations);
+    unsigned long long int below = 0;
+
+    for (unsigned int i = 0; i < displayMaxIterations; i++) {
+        equalised[i] = (unsigned int)(below * displayMaxIterations / escaped);
+        below += histogram[i];
+    }
+
+    return equalised;
+}
+
+// Colour and upload the latest published samples, SDL textures must only be touched from the main thread
+void FractalRenderer::updateFractalTexture() {
+    std::lock_guard<std::mutex> lock(renderMutex);
+
+    if (!displayBufferDirty && !recolourDisplay)
+        return;
+
+    displayBufferDirty = false;
+    recolourDisplay = false;
+
+    if (displaySamples.empty())
+        return;
+
+    colourDisplay();
+
+    int textureWidth = 0, textureHeight = 0;
+    if (fractalTexture)
+        SDL_QueryTexture(fractalTexture, nullptr, nullptr, &textureWidth, &textureHeight);
+
+    if (fractalTexture == nullptr || textureWidth != (int)displayWidth || textureHeight != (int)displayHeight) {
+        if (fractalTexture)
+            SDL_DestroyTexture(fractalTexture);
+
+        fractalTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, displayWidth, displayHeight);
+        if (fractalTexture == nullptr) {
+            SDL_Log("Failed to create texture: %s", SDL_GetError());
+            return;
+        }
+    }
+
+    if (SDL_UpdateTexture(fractalTexture, nullptr, displayBuffer.data(), displayWidth * sizeof(unsigned int)) < 0)
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Couldn't update fractal texture: %s", SDL_GetError());
 }
 
 void FractalRenderer::drawTrajectory(const std::vector<Complex>& trajectoryPoints) {
@@ -517,11 +1011,9 @@ void FractalRenderer::drawTrajectory(const std::vector<Complex>& trajectoryPoint
 }
 
 void FractalRenderer::drawFractalInfo() {
-        ImGuiWindowFlags_NoNav;
-
     ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_Once);
 
-    ImGui::Begin("Fractal Info", nullptr, windowFlags);
+    ImGui::Begin("Fractal Info", nullptr, BASE_WINDOW_FLAGS);
     ImGui::Text("Zoom: 10^%.5Lf", std::log10(zoom));
     ImGui::Text("Real: %.10Lf", offsetX);
     ImGui::Text("Imag: %.10Lf", offsetY);
@@ -623,9 +1115,9 @@ void FractalRenderer::drawRenderingSettings() {
     ImGui::Text("Resolution");
     ImGui::SameLine();
     ImGui::SetNextItemWidth(64);
-    if (ImGui::BeginCombo("##Resolution", resolutionOptions[curResolutionIdx].name.c_str())) {
+    if (ImGui::BeginCombo("##Resolution", resolutionOptions[previewResolutionIdx()].name.c_str())) {
         for (int i = 0; i < resolutionOptions.size(); i++) {
-            bool isSelected = curResolutionIdx == i;
+            bool isSelected = !dynamicResolution && curResolutionIdx == i;
             if (ImGui::Selectable(resolutionOptions[i].name.c_str(), isSelected))
                 selectResolution(i);
 
@@ -634,6 +1126,101 @@ void FractalRenderer::drawRenderingSettings() {
         ImGui::EndCombo();
     }
 
+    if (ImGui::Checkbox("Dynamic Resolution", &dynamicResolution))
+        beginAsyncRendering();
+
+    if (dynamicResolution) {
+        ImGui::SetNextItemWidth(96);
+        ImGui::SliderInt("Target Time", &targetFrameTime, 10, 500, "%d ms");
+    }
+
+    ImGui::Text("Mode");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(104);
+    if (ImGui::BeginCombo("##Render Mode", renderModeOptions[curRenderModeIdx].name.c_str())) {
+        for (int i = 0; i < renderModeOptions.size(); i++) {
+            bool isSelected = curRenderModeIdx == i;
+            if (ImGui::Selectable(renderModeOptions[i].name.c_str(), isSelected))
+                selectRenderMode(i);
+
+            if (isSelected) ImGui::SetItemDefaultFocus();
+        }
+        ImGui::EndCombo();
+    }
+
+    if (renderModeOptions[curRenderModeIdx].mode == renderMode::SOLID_GUESSING) {
+        if (ImGui::Checkbox("Compute Tiny Tiles", &solidGuessSafeTinyTiles))
+            beginAsyncRendering();
+    }
+
+    ImGui::Text("Anti-Aliasing");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(56);
+    if (ImGui::BeginCombo("##Anti-Aliasing", antiAliasOptions[curAntiAliasIdx].name.c_str())) {
+        for (int i = 0; i < antiAliasOptions.size(); i++) {
+            bool isSelected = curAntiAliasIdx == i;
+            if (ImGui::Selectable(antiAliasOptions[i].name.c_str(), isSelected))
+                selectAntiAliasing(i);
+
+            if (isSelected) ImGui::SetItemDefaultFocus();
+        }
+        ImGui::EndCombo();
+    }
+
+    if (antiAliasOptions[curAntiAliasIdx].grid > 0) {
+        // Extra samples as a multiple of the pixel count, uniform 4x4 supersampling would be 16
+        ImGui::SetNextItemWidth(96);
+        ImGui::SliderFloat("Sample Budget", &antiAliasBudget, 0.1f, 4.0f, "%.1fx");
+        if (ImGui::IsItemDeactivatedAfterEdit())
+            beginAsyncRendering();
+    }
+
+    if (ImGui::Checkbox("Adaptive Iterations", &adaptiveIterations))
+        beginAsyncRendering();
+
+    ImGui::Checkbox("Refine When Idle", &refineWhenIdle);
+
+    if (fractalOptions[curFractalIdx].mirrorSample) {
+        if (ImGui::Checkbox("Use Symmetry", &useSymmetry))
+            beginAsyncRendering();
+    }
+
+    ImGui::Separator();
+
+    ImGui::Text("Palette");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(96);
+    if (ImGui::BeginCombo("##Palette", paletteOptions[curPaletteIdx].name.c_str())) {
+        for (int i = 0; i < paletteOptions.size(); i++) {
+            bool isSelected = curPaletteIdx == i;
+            if (ImGui::Selectable(paletteOptions[i].name.c_str(), isSelected))
+                selectPalette(i);
+
+            if (isSelected) ImGui::SetItemDefaultFocus();
+        }
+        ImGui::EndCombo();
+    }
+
+    if (ImGui::Checkbox("Smooth Colours", &smoothColours)) {
+        recolourDisplay = true;
+
+        // Modes that fill tiles only fill escaped pixels without smooth colouring
+        renderMode mode = renderModeOptions[curRenderModeIdx].mode;
+        if (mode == renderMode::SOLID_GUESSING || mode == renderMode::BOUNDARY_TRACING || mode == renderMode::CERTIFIED_TILES)
+            beginAsyncRendering();
+    }
+
+    if (ImGui::Checkbox("Equalise Colours", &equaliseColours))
+        recolourDisplay = true;
+
+    if (ImGui::Checkbox("Cycle Colours", &cycleColours))
+        lastCycleTicks = SDL_GetTicks64();
+
+    if (cycleColours) {
+        ImGui::SetNextItemWidth(96);
+        ImGui::SliderFloat("Speed", &colourCycleSpeed, 0.01f, 1.0f);
+    }
+
     ImGui::End();
 }
 
@@ -647,6 +1234,8 @@ void  FractalRenderer::drawProgressBar() {
 }
 
 void FractalRenderer::renderFrame() {
+    updateFractalTexture();
+
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
@@ -678,6 +1267,7 @@ void FractalRenderer::run() {
     beginAsyncRendering();
 
     while (running) {
+        waitForEvents();
         handleEvents();
 
         if (destroyTrajectory && !isRecalculatingTrajectory) {
@@ -689,7 +1279,22 @@ void FractalRenderer::run() {
             destroyTrajectory = false;
         }
 
-        renderFrame();
+        if (cycleColours) {
+            // Shift the gradient along by however long the last frame took, so the speed doesn't depend on the frame rate
+            unsigned long long int ticks = SDL_GetTicks64();
+            colourCycleOffset = fmodf(colourCycleOffset + (ticks - lastCycleTicks) / 1000.0f * colourCycleSpeed, 1.0f);
+            lastCycleTicks = ticks;
+            recolourDisplay = true;
+        }
+
+        refineWhileIdle();
+
+        if (pendingFrames > 0 || cycleColours) {
+            renderFrame();
+
+            if (pendingFrames > 0)
+                pendingFrames--;
+        }
     }
 }
 
@@ -11,15 +11,93 @@
 #include <SDL2/SDL.h>
 
 #include "../complex/complex.hpp"
+#include "../complex/complex_interval.hpp"
 #include "../fractals/fractals.hpp"
+#include "../options/anti_alias_option.hpp"
 #include "../options/fractal_option.hpp"
+#include "../options/palette_option.hpp"
+#include "../options/render_mode_option.hpp"
 #include "../options/resolution_option.hpp"
+#include "progressive_pass.hpp"
+#include "sample_buffer.hpp"
 
 const unsigned int INITIAL_ZOOM = 1;
 const float INITIAL_OFFSET_X = 0.0;
 const float INITIAL_OFFSET_Y = 0.0;
 const unsigned int INITIAL_MAX_ITERATIONS = 5000;
 
+// Set on every pixel a render evaluates, including distance shading, so a cancelled render can still be reused
+const unsigned char PIXEL_COMPUTED = 1;
+// Set where a tile was filled in rather than computed
+const unsigned char PIXEL_FILLED = 2;
+
+// Steps the view is refined by while the user is idle, each one keeps the steps before it
+enum class refinement {
+    NONE,
+    ITERATIONS,
+    RESOLUTION,
+    ANTI_ALIASING
+};
+
+// Everything a render needs, captured when it starts so the view can change while it runs
+struct renderJob {
+    std::function<unsigned int(Complex, unsigned int, long double, orbitState&)> fractalFunc;
+    std::function<colour(unsigned int, unsigned int, const colourScheme&)> colourFunc;
+    bool colourLookup; // Samples are small integers, so they can be coloured from a lookup table
+    bool escapeTime;
+    std::function<long double(Complex, unsigned int, long double)> distanceFunc;
+    std::function<std::optional<unsigned int>(const ComplexInterval&, unsigned int)> tileFunc;
+    std::function<unsigned int(unsigned int)> mirrorSample;
+    unsigned int maxIterations;
+    float lengthScaleFactor;
+    unsigned int width;
+    unsigned int height;
+    float halfWinWidth;
+    float halfWinHeight;
+    double fractalWidthRatio;
+    double fractalHeightRatio;
+    long double offsetX;
+    long double offsetY;
+    long double pixelSpacing;
+    unsigned int antiAliasGrid; // Subsamples along each side of an edge pixel, 0 for no anti-aliasing
+    float antiAliasBudget; // Most subsamples to take, as a multiple of the pixel count
+    renderMode mode;
+    bool safeTinyTiles; // Solid guessing computes tiny tiles rather than filling them
+    bool smoothFills; // Only fill pixels that didn't escape, escaped pixels each need their own escape fraction
+    std::vector<int> mirrorRows; // Row each row is copied from by symmetry, -1 if it is computed, empty if none are copied
+    std::vector<bool> knownPixels; // Pixels already filled in from a previous frame, empty if none are
+    std::unordered_map<unsigned long long int, orbitState> resumeOrbits; // Orbits a previous frame left unfinished, by pixel index
+};
+
+// A finished render, cached so renders of overlapping views can reuse its pixels
+struct renderedFrame {
+    renderJob job;
+    unsigned int fractalIdx;
+    bool distanceShaded;
+    SampleBuffer samples;
+    std::vector<unsigned char> escapeFractions; // Empty unless the samples are escape iterations
+    std::vector<bool> validPixels; // Pixels worth reusing, those finished before a cancel and not filled in as unfinished, empty if all are
+    std::vector<bool> filledPixels; // Pixels filled in from their surroundings rather than computed, empty if none were
+    std::unordered_map<unsigned long long int, orbitState> unfinishedOrbits; // Orbits that reached the limit, by pixel index, dropped once another view is cached
+};
+
+// Extra samples spread over the pixels on edges, each of these pixels is coloured with the average of its subsamples
+struct subsampleTable {
+    unsigned int grid = 0; // Subsamples along each side of a pixel
+    std::vector<unsigned long long int> pixels; // Index of each supersampled pixel
+    std::vector<unsigned int> samples; // grid * grid per pixel, row by row
+    std::vector<unsigned char> fractions; // Escape fraction of each subsample, like pixelFractionBuffer
+};
+
+unsigned int solidGuessingTileCount(unsigned int width, unsigned int height);
+unsigned int boundaryTracingTileCount(unsigned int width, unsigned int height);
+unsigned int distanceEstimationTileCount(unsigned int width, unsigned int height);
+unsigned int certifiedTileCount(unsigned int width, unsigned int height);
+std::vector<int> mirroredRows(const renderJob& job);
+unsigned int distanceSample(float pixelDistance);
+colour colourDistanceSample(unsigned int sample, unsigned int maxIterations, const colourScheme& scheme);
+bool parallelFor(unsigned int count, const std::function<void(unsigned int)>& func, const std::function<bool()>& cancelled);
+
 class FractalRenderer {
     public:
         FractalRenderer(unsigned int width, unsigned int height);
@@ -28,7 +106,9 @@ class FractalRenderer {
         void run();
 
     private:
+        void waitForEvents();
         void handleEvents();
+        void requestRedraw();
 
         void setWindowSize(unsigned int width, unsigned int height);
         void refreshFractalSize();
@@ -36,9 +116,37 @@ class FractalRenderer {
         void setFractalOffset(long double real, long double imag);
         void setZoomLevel(long double zoomPower);
         void selectResolution(unsigned int resolutionIndex);
+        void selectRenderMode(unsigned int renderModeIndex);
+        void selectAntiAliasing(unsigned int antiAliasIndex);
         void selectFractal(unsigned int fractalIndex);
+        void selectPalette(unsigned int paletteIndex);
 
-        void beginAsyncRendering(bool fullRender = false);
+        void beginAsyncRendering(bool fullRender = false, refinement level = refinement::NONE);
+        void cancelRefinement();
+        void refineWhileIdle();
+        void renderStandard(const renderJob& job);
+        void renderProgressive(const renderJob& job);
+        void renderSolidGuessing(const renderJob& job);
+        void subdivideTile(const renderJob& job, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1);
+        void renderBoundaryTracing(const renderJob& job);
+        void traceTile(const renderJob& job, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1);
+        void renderDistanceEstimation(const renderJob& job);
+        void renderCertifiedTiles(const renderJob& job);
+        void certifyTile(const renderJob& job, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1);
+        void renderAntiAliasing(const renderJob& job);
+        void reuseCachedFrames(renderJob& job, unsigned int fractalIdx, bool distanceShaded);
+        void storeFrame(const renderJob& job, unsigned int fractalIdx, bool distanceShaded, bool finished);
+        void updateIterationBudget(const renderJob& job);
+        void updateDynamicResolution(const renderJob& job, double renderTime);
+        unsigned int previewResolutionIdx();
+        bool renderPixels(const renderJob& job, unsigned int startX, unsigned int startY, unsigned int stepX, unsigned int stepY);
+        unsigned long long int tileBorderCost(const renderJob& job, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1);
+        unsigned int computePixel(const renderJob& job, unsigned int x, unsigned int y, orbitState* unfinishedOrbit = nullptr);
+        bool isPixelKnown(const renderJob& job, unsigned int x, unsigned int y);
+        void publishPixelData(const renderJob& job, unsigned int blockWidth, unsigned int blockHeight);
+        void colourDisplay();
+        std::vector<unsigned int> equaliseIterations();
+        void updateFractalTexture();
         void drawTrajectory(const std::vector<Complex>& trajectoryPoints);
 
         void drawFractalInfo();
@@ -63,7 +171,6 @@ class FractalRenderer {
         SDL_Window* window = nullptr;
         SDL_Renderer* renderer = nullptr;
         SDL_Texture* fractalTexture = nullptr;
-        SDL_Texture* fractalTextureBuffer = nullptr;
 
         long double zoom = INITIAL_ZOOM;
         long double numZooms = 0.0;
@@ -71,6 +178,8 @@ class FractalRenderer {
         long double offsetY = INITIAL_OFFSET_Y;
         unsigned int maxIterations = INITIAL_MAX_ITERATIONS;
         unsigned int curMaxIterations;
+        bool adaptiveIterations = true;
+        std::atomic<unsigned int> iterationBudget; // Limit the last finished render suggests for the next, 0 if there isn't one
 
         SDL_Texture* trajectoryTexture = nullptr;
         bool recalculateTrajectory = false;
@@ -82,17 +191,74 @@ class FractalRenderer {
 
         std::atomic<bool> isRecalculatingFractal;
         std::atomic<bool> cancelRender;
+        std::function<bool()> renderCancelled; // Reads cancelRender, for handing to parallelFor from render threads
+        std::atomic<bool> redrawRequested; // A redraw event is queued and hasn't been handled yet
+        Uint32 redrawEventType = (Uint32)-1;
+        unsigned int pendingFrames = 1; // Frames still to draw before the main loop can sleep
         std::future<void> renderingTask;
         std::mutex renderMutex;
         std::vector<unsigned int> pixelDataBuffer;
+        std::vector<unsigned char> pixelFractionBuffer; // Escape fraction of each escaped pixel in 1/256ths, for smooth colouring
+        subsampleTable subsamples;
+        std::vector<unsigned char> pixelFlags; // PIXEL_COMPUTED and PIXEL_FILLED bits of each pixel of the current render
+        std::vector<std::pair<unsigned long long int, orbitState>> unfinishedOrbits; // Orbits of this render that reached the limit
+        std::mutex orbitMutex;
+        std::vector<unsigned int> displaySamples; // Latest published samples, coloured on the main thread
+        std::vector<unsigned char> displayFractions;
+        std::vector<unsigned int> displayEqualised; // Histogram-equalised iteration of each escape iteration, empty if nothing escaped
+        bool displayEqualisedStale = true; // The samples changed since displayEqualised was built
+        subsampleTable displaySubsamples;
+        std::function<colour(unsigned int, unsigned int, const colourScheme&)> displayColourFunc;
+        unsigned int displayMaxIterations = 0;
+        bool displayColourLookup = false;
+        bool displayEscapeTime = false;
+        unsigned int displayWidth = 0;
+        unsigned int displayHeight = 0;
+        bool displayBufferDirty = false;
+        std::vector<unsigned int> displayBuffer;
+        std::vector<unsigned int> colourLookupTable; // Packed colour of each sample, the last entry is shared by every larger sample
+        SDL_PixelFormat* displayFormat = nullptr;
+        bool recolourDisplay = false; // The colour scheme changed, so the samples need colouring again
+        std::vector<renderedFrame> frameCache; // Newest first
         std::atomic<unsigned int> renderProgress;
         unsigned int renderMaxProgress;
 
         std::vector<resolutionOption> resolutionOptions;
         unsigned int curResolutionIdx;
+        bool dynamicResolution = false;
+        int targetFrameTime = 50; // Milliseconds
+        std::atomic<double> renderThroughput; // Pixel iterations per millisecond, averaged over recent renders
+        std::atomic<double> pixelCost; // Mean iterations of the pixels computed by the last render
+        unsigned int throughputFractalIdx = 0; // Fractal the throughput was measured on, some count pixel costs in iterations and some don't
+        renderMode throughputMode = renderMode::STANDARD; // Likewise for the render mode, distance shading counts each computed pixel once
+
+        std::vector<renderModeOption> renderModeOptions;
+        unsigned int curRenderModeIdx;
+        bool solidGuessSafeTinyTiles = true;
+
+        bool refineWhenIdle = true;
+        refinement renderingRefinement = refinement::NONE; // Refinement of the render started last
+        std::atomic<refinement> finishedRefinement; // Refinement of the last render that finished
+        std::atomic<float> finishedScaleFactor; // Resolution of the last render that finished, the newest cached frame may be a cancelled one
+        std::atomic<unsigned int> finishedMaxIterations; // Limit of the last render that finished, curMaxIterations is the last one started
+        unsigned long long int lastInputTicks = 0;
+
+        std::vector<antiAliasOption> antiAliasOptions;
+        unsigned int curAntiAliasIdx;
+        float antiAliasBudget = 1.0f;
+        bool useSymmetry = true;
 
         std::vector<fractalOption> fractalOptions;
         unsigned int curFractalIdx;
+
+        std::vector<paletteOption> paletteOptions;
+        unsigned int curPaletteIdx;
+        bool smoothColours = false;
+        bool equaliseColours = false;
+        bool cycleColours = false;
+        float colourCycleSpeed = 0.1f; // Gradient lengths per second
+        float colourCycleOffset = 0.0f;
+        unsigned long long int lastCycleTicks = 0;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+
+#include "fractal_renderer.hpp"
+
+const long double REUSE_TOLERANCE = 1e-3; // Fraction of a pixel two samples may be apart and still count as the same point
+const unsigned int FRAME_CACHE_SIZE = 4; // Enough to keep a frame for each resolution recently switched between
+
+// Match up the samples along one axis of two views, giving the old sample at the same coordinate as each new one or -1
+// Screen position p along the axis is at (p - half) * step + offset, step is negative for the imaginary axis
+static std::vector<int> matchAxisSamples(
+    unsigned int count, float lengthScaleFactor, float half, long double step, long double offset,
+    unsigned int oldCount, float oldLengthScaleFactor, float oldHalf, long double oldStep, long double oldOffset
+) {
+    std::vector<int> matches(count, -1);
+    if (oldCount == 0)
+        return matches;
+
+    // Each sample is at screen position index / lengthScaleFactor, matching computePixel
+    std::vector<int> oldSampleAt((unsigned int)((oldCount - 1) / oldLengthScaleFactor) + 1, -1);
+    for (unsigned int i = 0; i < oldCount; i++)
+        oldSampleAt[(unsigned int)(i / oldLengthScaleFactor)] = i;
+
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned int p = (unsigned int)(i / lengthScaleFactor);
+
+        // Offsets are subtracted first so the difference keeps its precision when zoomed in
+        long double oldPosition = (offset - oldOffset) / oldStep + (p - half) * step / oldStep + oldHalf;
+        long double rounded = std::round(oldPosition);
+        if (std::abs(oldPosition - rounded) > REUSE_TOLERANCE || rounded < 0 || rounded >= oldSampleAt.size())
+            continue;
+
+        matches[i] = oldSampleAt[(unsigned int)rounded];
+    }
+
+    return matches;
+}
+
+// Whether a cached frame's pixels can stand in for pixels of this job at the same point
+static bool frameMatchesJob(const renderedFrame& frame, const renderJob& job, unsigned int fractalIdx, bool distanceShaded) {
+    if (frame.fractalIdx != fractalIdx || frame.distanceShaded != distanceShaded)
+        return false;
+
+    // Distance shading is measured in pixels, so only carries over at the same zoom and limit
+    if (distanceShaded)
+        return frame.job.maxIterations == job.maxIterations && frame.job.pixelSpacing == job.pixelSpacing;
+
+    // Escape iterations carry over to any limit, other samples don't say when they were found so only carry over to higher ones
+    return job.escapeTime || frame.job.maxIterations <= job.maxIterations;
+}
+
+// Whether the pixels a frame filled in rather than computed can stand in for this job's, guesses are only as good
+// as the method that made them so are kept to that method
+static bool fillsMatchJob(const renderedFrame& frame, const renderJob& job) {
+    // Certified fills are exact
+    if (frame.job.mode == renderMode::CERTIFIED_TILES)
+        return true;
+
+    if (frame.job.mode != job.mode)
+        return false;
+
+    return job.mode != renderMode::SOLID_GUESSING || frame.job.safeTinyTiles == job.safeTinyTiles;
+}
+
+static bool sameView(const renderJob& a, const renderJob& b) {
+    return a.width == b.width && a.height == b.height && a.lengthScaleFactor == b.lengthScaleFactor &&
+        a.halfWinWidth == b.halfWinWidth && a.halfWinHeight == b.halfWinHeight &&
+        a.fractalWidthRatio == b.fractalWidthRatio && a.fractalHeightRatio == b.fractalHeightRatio &&
+        a.offsetX == b.offsetX && a.offsetY == b.offsetY;
+}
+
+// Seed the pixel buffer with every pixel of the cached frames that samples the same point as a pixel of this job
+void FractalRenderer::reuseCachedFrames(renderJob& job, unsigned int fractalIdx, bool distanceShaded) {
+    std::vector<bool> known((unsigned long long int)job.width * job.height, false);
+    bool anyKnown = false;
+
+    // Newest frames first, older ones only fill in what is still missing
+    for (const renderedFrame& frame : frameCache) {
+        if (!frameMatchesJob(frame, job, fractalIdx, distanceShaded))
+            continue;
+
+        // Samples are always on whole screen pixels, so lower resolutions are a subset of higher ones
+        // Zooming by a power of 2 keeps every other sample aligned, zooming in reuses the old centre quarter on alternate
+        // pixels and zooming out reuses the whole old frame in the centre at half resolution
+        // Resizing keeps samples aligned while the pixel spacing is unchanged and the centre stays on a whole pixel
+        const renderJob& old = frame.job;
+        bool reuseFills = fillsMatchJob(frame, job);
+        std::vector<int> columns = matchAxisSamples(
+            job.width, job.lengthScaleFactor, job.halfWinWidth, job.fractalWidthRatio, job.offsetX,
+            old.width, old.lengthScaleFactor, old.halfWinWidth, old.fractalWidthRatio, old.offsetX
+        );
+        std::vector<int> rows = matchAxisSamples(
+            job.height, job.lengthScaleFactor, job.halfWinHeight, -job.fractalHeightRatio, job.offsetY,
+            old.height, old.lengthScaleFactor, old.halfWinHeight, -old.fractalHeightRatio, old.offsetY
+        );
+
+        for (unsigned int y = 0; y < job.height; y++) {
+            if (rows[y] < 0)
+                continue;
+
+            unsigned long long int row = (unsigned long long int)y * job.width;
+            unsigned long long int oldRow = (unsigned long long int)rows[y] * old.width;
+
+            for (unsigned int x = 0; x < job.width; x++) {
+                unsigned long long int oldIndex = oldRow + columns[x];
+                if (known[row + x] || columns[x] < 0 || (!frame.validPixels.empty() && !frame.validPixels[oldIndex]))
+                    continue;
+
+                bool filled = !frame.filledPixels.empty() && frame.filledPixels[oldIndex];
+                if (filled && !reuseFills)
+                    continue;
+
+                unsigned int sample = frame.samples[oldIndex];
+
+                // Escaped pixels filled without smooth colouring share one escape fraction
+                if (filled && job.smoothFills && !old.smoothFills && sample < old.maxIterations)
+                    continue;
+
+                // Escapes past a lower limit haven't happened yet at this one
+                if (!distanceShaded && sample < SAMPLE_UNFINISHED && job.escapeTime && sample >= job.maxIterations)
+                    continue;
+
+                if (sample == SAMPLE_UNFINISHED && !distanceShaded) {
+                    auto orbit = frame.unfinishedOrbits.find(oldIndex);
+
+                    // Carry on iterating from where the orbit stopped, or start again if the frame didn't keep it
+                    // An orbit kept from an even higher limit may have iterated further than this frame's limit
+                    unsigned int iterated = orbit != frame.unfinishedOrbits.end() ? orbit->second.iteration : old.maxIterations;
+                    if (iterated < job.maxIterations) {
+                        if (orbit != frame.unfinishedOrbits.end())
+                            job.resumeOrbits.emplace(row + x, orbit->second);
+
+                        continue;
+                    }
+
+                    // Still unfinished, keep the orbit for later frames
+                    if (orbit != frame.unfinishedOrbits.end())
+                        unfinishedOrbits.emplace_back(row + x, orbit->second);
+                }
+
+                pixelDataBuffer[row + x] = sample;
+                if (!frame.escapeFractions.empty())
+                    pixelFractionBuffer[row + x] = frame.escapeFractions[oldIndex];
+
+                pixelFlags[row + x] = filled ? PIXEL_FILLED : 0;
+                known[row + x] = true;
+                anyKnown = true;
+            }
+        }
+    }
+
+    if (anyKnown)
+        job.knownPixels = std::move(known);
+}
+
+void FractalRenderer::storeFrame(const renderJob& job, unsigned int fractalIdx, bool distanceShaded, bool finished) {
+    std::vector<bool> valid;
+
+    // Tiles filled in as unfinished, like certified ones, have no orbits to carry on from when the limit is raised,
+    // so aren't kept and are certified or computed again instead
+    auto unresumable = [this, distanceShaded](unsigned long long int i) {
+        return !distanceShaded && (pixelFlags[i] & PIXEL_FILLED) && pixelDataBuffer[i] == SAMPLE_UNFINISHED;
+    };
+
+    bool anyUnresumable = false;
+    for (unsigned long long int i = 0; i < pixelDataBuffer.size() && !anyUnresumable; i++)
+        anyUnresumable = unresumable(i);
+
+    // A cancelled render has only finished its reused and computed pixels, every mode flags the pixels it computes
+    if (!finished || anyUnresumable) {
+        valid.resize(pixelDataBuffer.size(), false);
+        bool anyValid = false;
+
+        for (unsigned long long int i = 0; i < valid.size(); i++) {
+            bool done = finished || (pixelFlags[i] & PIXEL_COMPUTED) || (!job.knownPixels.empty() && job.knownPixels[i]);
+            valid[i] = done && !unresumable(i);
+            anyValid = anyValid || valid[i];
+        }
+
+        // Nothing worth caching
+        if (!anyValid)
+            return;
+    }
+
+    std::vector<bool> filled;
+    if (std::any_of(pixelFlags.begin(), pixelFlags.end(), [](unsigned char flags) { return flags & PIXEL_FILLED; })) {
+        filled.resize(pixelFlags.size());
+        for (unsigned long long int i = 0; i < filled.size(); i++)
+            filled[i] = pixelFlags[i] & PIXEL_FILLED;
+    }
+
+    // Any frame of the same view at the same or a lower limit had all its pixels reused by this one, unless this one
+    // guessed pixels the frame had computed
+    frameCache.erase(std::remove_if(frameCache.begin(), frameCache.end(), [&](const renderedFrame& frame) {
+        return frameMatchesJob(frame, job, fractalIdx, distanceShaded) && sameView(frame.job, job) && frame.job.maxIterations <= job.maxIterations &&
+            (frame.filledPixels.empty() ? filled.empty() : fillsMatchJob(frame, job) && (frame.job.smoothFills || !job.smoothFills));
+    }), frameCache.end());
+
+    if (frameCache.size() >= FRAME_CACHE_SIZE)
+        frameCache.pop_back();
+
+    std::unordered_map<unsigned long long int, orbitState> orbits(unfinishedOrbits.begin(), unfinishedOrbits.end());
+    // Distance samples are float bits so always need the full width
+    SampleBuffer samples(pixelDataBuffer, !distanceShaded && SampleBuffer::fitsNarrow(job.maxIterations));
+    std::vector<unsigned char> fractions;
+    if (job.escapeTime && !distanceShaded)
+        fractions = pixelFractionBuffer;
+
+    frameCache.insert(frameCache.begin(), renderedFrame{ job, fractalIdx, distanceShaded, std::move(samples), std::move(fractions), std::move(valid), std::move(filled), std::move(orbits) });
+
+    // Only the view is needed to match against later renders
+    renderedFrame& frame = frameCache.front();
+    frame.job.mirrorRows = {};
+    frame.job.knownPixels = {};
+    frame.job.resumeOrbits = {};
+
+    // Raising the limit resumes the view on screen, other views' orbits take a lot of memory for little use
+    for (unsigned int i = 1; i < frameCache.size(); i++) {
+        if (!sameView(frameCache[i].job, job))
+            frameCache[i].unfinishedOrbits = {};
+    }
+}
+
+bool FractalRenderer::isPixelKnown(const renderJob& job, unsigned int x, unsigned int y) {
+    return !job.knownPixels.empty() && job.knownPixels[(unsigned long long int)y * job.width + x];
+}
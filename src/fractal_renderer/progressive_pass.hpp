@@ -0,0 +1,26 @@
+#ifndef PROGRESSIVE_PASS_H
+#define PROGRESSIVE_PASS_H
+
+// One interleaved pass of a progressive render, every pixel at (startX + n * stepX, startY + m * stepY) is computed
+struct progressivePass {
+    unsigned int startX;
+    unsigned int startY;
+    unsigned int stepX;
+    unsigned int stepY;
+
+    // Size of the block each computed pixel stands in for once the pass has finished
+    unsigned int blockWidth;
+    unsigned int blockHeight;
+};
+
+// Adam7-style interlacing on a 4x4 grid, starting at 1/16 resolution
+// Each pass only computes pixels that no previous pass has touched
+const progressivePass PROGRESSIVE_PASSES[] = {
+    { 0, 0, 4, 4, 4, 4 },
+    { 2, 0, 4, 4, 2, 4 },
+    { 0, 2, 2, 4, 2, 2 },
+    { 1, 0, 2, 2, 1, 2 },
+    { 0, 1, 1, 2, 1, 1 },
+};
+
+#endif
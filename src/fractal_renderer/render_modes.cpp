@@ -0,0 +1,773 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <thread>
+#include <tuple>
+
+#include "fractal_renderer.hpp"
+
+const unsigned int SOLID_GUESS_TILE_SIZE = 64;
+const unsigned int SOLID_GUESS_TINY_TILE_SIZE = 8;
+const unsigned int BOUNDARY_TRACE_TILE_SIZE = 128;
+const unsigned int DISTANCE_TILE_SIZE = 128;
+const unsigned int CERTIFIED_TILE_SIZE = 64;
+const unsigned int CERTIFIED_MIN_TILE_SIZE = 4;
+const long double CERTIFIED_TILE_MARGIN = 1e-3; // Fraction of a pixel the tile rectangle is widened by, covers rounding of pixel positions
+const unsigned int ANTI_ALIAS_EDGE_ITERATIONS = 2; // Escape iterations neighbours must differ by to be an edge, neighbouring bands differ by 1
+const long double MIRROR_AXIS_TOLERANCE = 1e-3; // Fraction of a pixel the real axis may be off a row or half row and still be mirrored
+
+// Grid line positions splitting a length into tiles, both ends are always included
+static std::vector<unsigned int> solidGuessingGridLines(unsigned int length) {
+    std::vector<unsigned int> lines;
+    for (unsigned int i = 0; i + 1 < length; i += SOLID_GUESS_TILE_SIZE)
+        lines.push_back(i);
+    lines.push_back(length > 0 ? length - 1 : 0);
+
+    return lines;
+}
+
+// Tile indices ordered most expensive first, so slow boundary tiles start straight away and cheap tiles fill in around them
+// rather than one slow tile being left running alone at the end
+static std::vector<unsigned int> expensiveTilesFirst(const std::vector<unsigned long long int>& costs) {
+    std::vector<unsigned int> order(costs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&costs](unsigned int a, unsigned int b) {
+        return costs[a] > costs[b];
+    });
+
+    return order;
+}
+
+unsigned int solidGuessingTileCount(unsigned int width, unsigned int height) {
+    return (unsigned int)((solidGuessingGridLines(width).size() - 1) * (solidGuessingGridLines(height).size() - 1));
+}
+
+unsigned int boundaryTracingTileCount(unsigned int width, unsigned int height) {
+    return ((width + BOUNDARY_TRACE_TILE_SIZE - 1) / BOUNDARY_TRACE_TILE_SIZE) * ((height + BOUNDARY_TRACE_TILE_SIZE - 1) / BOUNDARY_TRACE_TILE_SIZE);
+}
+
+unsigned int distanceEstimationTileCount(unsigned int width, unsigned int height) {
+    return ((width + DISTANCE_TILE_SIZE - 1) / DISTANCE_TILE_SIZE) * ((height + DISTANCE_TILE_SIZE - 1) / DISTANCE_TILE_SIZE);
+}
+
+unsigned int certifiedTileCount(unsigned int width, unsigned int height) {
+    return ((width + CERTIFIED_TILE_SIZE - 1) / CERTIFIED_TILE_SIZE) * ((height + CERTIFIED_TILE_SIZE - 1) / CERTIFIED_TILE_SIZE);
+}
+
+// Pair up rows that sample reflections of each other in the real axis, so only one row of each pair is computed
+// The 3-fold rotational symmetry of the Tricorn and Newton fractal isn't used, turning by 120 degrees brings in a factor
+// of sqrt(3) / 2 so rotated samples never land back on the square pixel grid
+std::vector<int> mirroredRows(const renderJob& job) {
+    if (!job.mirrorSample || job.height == 0)
+        return {};
+
+    // Screen rows py and axisSum - py are reflections of each other, which needs the axis on a row or halfway between two
+    long double axisSum = 2.0 * job.halfWinHeight + 2.0 * job.offsetY / job.fractalHeightRatio;
+    long double roundedSum = std::round(axisSum);
+    if (std::abs(axisSum - roundedSum) > MIRROR_AXIS_TOLERANCE || roundedSum < 0)
+        return {};
+
+    // Each row samples the screen row y / lengthScaleFactor, matching computePixel
+    auto screenRow = [&job](unsigned int y) {
+        return (unsigned int)(y / job.lengthScaleFactor);
+    };
+
+    std::vector<int> rowAtScreenRow(screenRow(job.height - 1) + 1, -1);
+    for (unsigned int y = 0; y < job.height; y++)
+        rowAtScreenRow[screenRow(y)] = y;
+
+    std::vector<int> rows(job.height, -1);
+    bool anyMirrored = false;
+
+    for (unsigned int y = 0; y < job.height; y++) {
+        long long int mirrorScreenRow = (long long int)roundedSum - screenRow(y);
+        if (mirrorScreenRow < 0 || mirrorScreenRow >= (long long int)rowAtScreenRow.size())
+            continue;
+
+        // The earlier row of each pair is computed
+        int partner = rowAtScreenRow[mirrorScreenRow];
+        if (partner >= 0 && partner < (int)y) {
+            rows[y] = partner;
+            anyMirrored = true;
+        }
+    }
+
+    if (!anyMirrored)
+        return {};
+
+    return rows;
+}
+
+// Distance shaded renders keep each pixel's distance to the boundary in pixels as the bits of a float
+unsigned int distanceSample(float pixelDistance) {
+    unsigned int sample;
+    std::memcpy(&sample, &pixelDistance, sizeof(sample));
+    return sample;
+}
+
+colour colourDistanceSample(unsigned int sample, unsigned int maxIterations, const colourScheme& scheme) {
+    float pixelDistance;
+    std::memcpy(&pixelDistance, &sample, sizeof(pixelDistance));
+    return colourDistance(pixelDistance);
+}
+
+void FractalRenderer::renderStandard(const renderJob& job) {
+    if (!renderPixels(job, 0, 0, 1, 1))
+        return;
+
+    publishPixelData(job, 1, 1);
+}
+
+void FractalRenderer::renderProgressive(const renderJob& job) {
+    // Every pass fills in pixels between the ones already computed, so the preview sharpens without repeating work
+    for (const progressivePass& pass : PROGRESSIVE_PASSES) {
+        if (!renderPixels(job, pass.startX, pass.startY, pass.stepX, pass.stepY))
+            return;
+
+        publishPixelData(job, pass.blockWidth, pass.blockHeight);
+    }
+}
+
+// Mariani-Silver subdivision, tiles whose border is a single colour are filled without computing their interior
+void FractalRenderer::renderSolidGuessing(const renderJob& job) {
+    std::vector<unsigned int> gridX = solidGuessingGridLines(job.width);
+    std::vector<unsigned int> gridY = solidGuessingGridLines(job.height);
+
+    // Compute the grid lines first, neighbouring tiles share these as their borders
+    bool completed = parallelFor(gridY.size(), [this, &job, &gridY](unsigned int i) {
+        for (unsigned int x = 0; x < job.width && !cancelRender; x++)
+            computePixel(job, x, gridY[i]);
+    }, renderCancelled);
+    if (!completed)
+        return;
+
+    completed = parallelFor(gridX.size(), [this, &job, &gridX](unsigned int i) {
+        for (unsigned int y = 0; y < job.height && !cancelRender; y++) {
+            if (y % SOLID_GUESS_TILE_SIZE != 0 && y != job.height - 1)
+                computePixel(job, gridX[i], y);
+        }
+    }, renderCancelled);
+    if (!completed)
+        return;
+
+    unsigned int tilesX = gridX.size() - 1;
+    unsigned int tilesY = gridY.size() - 1;
+
+    // The grid lines give every tile's border, which predicts how much of it needs subdividing
+    std::vector<unsigned long long int> costs(tilesX * tilesY);
+    for (unsigned int i = 0; i < costs.size(); i++)
+        costs[i] = tileBorderCost(job, gridX[i % tilesX], gridY[i / tilesX], gridX[i % tilesX + 1], gridY[i / tilesX + 1]);
+
+    std::vector<unsigned int> order = expensiveTilesFirst(costs);
+
+    completed = parallelFor(tilesX * tilesY, [this, &job, &gridX, &gridY, &order, tilesX](unsigned int i) {
+        unsigned int tileX = order[i] % tilesX;
+        unsigned int tileY = order[i] / tilesX;
+
+        subdivideTile(job, gridX[tileX], gridY[tileY], gridX[tileX + 1], gridY[tileY + 1]);
+        renderProgress++;
+    }, renderCancelled);
+    if (!completed)
+        return;
+
+    publishPixelData(job, 1, 1);
+}
+
+// Fill or split the tile spanning x0..x1 and y0..y1 inclusive, its border must already be computed
+void FractalRenderer::subdivideTile(const renderJob& job, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1) {
+    if (cancelRender || x1 - x0 < 2 || y1 - y0 < 2)
+        return;
+
+    auto pixelAt = [this, &job](unsigned int x, unsigned int y) -> unsigned int& {
+        return pixelDataBuffer[(unsigned long long int)y * job.width + x];
+    };
+
+    // Check whether the whole border is one colour
+    unsigned int borderValue = pixelAt(x0, y0);
+    bool uniform = true;
+
+    for (unsigned int x = x0; x <= x1 && uniform; x++)
+        uniform = pixelAt(x, y0) == borderValue && pixelAt(x, y1) == borderValue;
+
+    for (unsigned int y = y0; y <= y1 && uniform; y++)
+        uniform = pixelAt(x0, y) == borderValue && pixelAt(x1, y) == borderValue;
+
+    bool tiny = x1 - x0 < SOLID_GUESS_TINY_TILE_SIZE || y1 - y0 < SOLID_GUESS_TINY_TILE_SIZE;
+    bool smoothBorder = job.smoothFills && borderValue < job.maxIterations;
+
+    if (uniform && !(tiny && job.safeTinyTiles) && !smoothBorder) {
+        unsigned char borderFraction = pixelFractionBuffer[(unsigned long long int)y0 * job.width + x0];
+
+        // Pixels reused from a previous frame are kept rather than replaced by a guess
+        for (unsigned int y = y0 + 1; y < y1; y++) {
+            for (unsigned int x = x0 + 1; x < x1; x++) {
+                if (isPixelKnown(job, x, y))
+                    continue;
+
+                unsigned long long int index = (unsigned long long int)y * job.width + x;
+                pixelAt(x, y) = borderValue;
+                pixelFractionBuffer[index] = borderFraction;
+                pixelFlags[index] = PIXEL_FILLED;
+            }
+        }
+
+        return;
+    }
+
+    // Too small to be worth splitting any further
+    if (tiny) {
+        for (unsigned int y = y0 + 1; y < y1 && !cancelRender; y++)
+            for (unsigned int x = x0 + 1; x < x1; x++)
+                computePixel(job, x, y);
+
+        return;
+    }
+
+    // Compute a cross through the middle, giving four tiles with known borders
+    unsigned int midX = (x0 + x1) / 2;
+    unsigned int midY = (y0 + y1) / 2;
+
+    for (unsigned int x = x0 + 1; x < x1; x++)
+        computePixel(job, x, midY);
+
+    for (unsigned int y = y0 + 1; y < y1; y++) {
+        if (y != midY)
+            computePixel(job, midX, y);
+    }
+
+    subdivideTile(job, x0, y0, midX, midY);
+    subdivideTile(job, midX, y0, x1, midY);
+    subdivideTile(job, x0, midY, midX, y1);
+    subdivideTile(job, midX, midY, x1, y1);
+}
+
+// Trace the contours between colour bands and flood-fill what they enclose, each tile is traced independently
+void FractalRenderer::renderBoundaryTracing(const renderJob& job) {
+    unsigned int tilesX = (job.width + BOUNDARY_TRACE_TILE_SIZE - 1) / BOUNDARY_TRACE_TILE_SIZE;
+    unsigned int tilesY = (job.height + BOUNDARY_TRACE_TILE_SIZE - 1) / BOUNDARY_TRACE_TILE_SIZE;
+
+    auto tileBounds = [&job, tilesX](unsigned int i) {
+        unsigned int x0 = (i % tilesX) * BOUNDARY_TRACE_TILE_SIZE;
+        unsigned int y0 = (i / tilesX) * BOUNDARY_TRACE_TILE_SIZE;
+        return std::make_tuple(x0, y0, std::min(x0 + BOUNDARY_TRACE_TILE_SIZE, job.width), std::min(y0 + BOUNDARY_TRACE_TILE_SIZE, job.height));
+    };
+
+    // Every tile is seeded from its edges anyway, computing them first predicts how much tracing each tile needs
+    std::vector<unsigned long long int> costs(tilesX * tilesY);
+
+    bool completed = parallelFor(tilesX * tilesY, [this, &job, &tileBounds, &costs](unsigned int i) {
+        auto [x0, y0, x1, y1] = tileBounds(i);
+
+        for (unsigned int x = x0; x < x1; x++) {
+            computePixel(job, x, y0);
+            computePixel(job, x, y1 - 1);
+        }
+
+        for (unsigned int y = y0; y < y1; y++) {
+            computePixel(job, x0, y);
+            computePixel(job, x1 - 1, y);
+        }
+
+        costs[i] = tileBorderCost(job, x0, y0, x1 - 1, y1 - 1);
+    }, renderCancelled);
+    if (!completed)
+        return;
+
+    std::vector<unsigned int> order = expensiveTilesFirst(costs);
+
+    completed = parallelFor(tilesX * tilesY, [this, &job, &tileBounds, &order](unsigned int i) {
+        auto [x0, y0, x1, y1] = tileBounds(order[i]);
+
+        traceTile(job, x0, y0, x1, y1);
+        renderProgress++;
+    }, renderCancelled);
+    if (!completed)
+        return;
+
+    publishPixelData(job, 1, 1);
+}
+
+// Boundary trace the tile spanning x0..x1 and y0..y1 exclusive, seeded from its edges
+void FractalRenderer::traceTile(const renderJob& job, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1) {
+    const unsigned char LOADED = 1;
+    const unsigned char QUEUED = 2;
+
+    unsigned int tileWidth = x1 - x0;
+    unsigned int tileHeight = y1 - y0;
+
+    std::vector<unsigned char> state((unsigned long long int)tileWidth * tileHeight, 0);
+    std::vector<unsigned int> queue;
+
+    auto pixelAt = [this, &job, x0, y0](unsigned int tx, unsigned int ty) -> unsigned int& {
+        return pixelDataBuffer[(unsigned long long int)(y0 + ty) * job.width + x0 + tx];
+    };
+
+    auto load = [this, &job, &state, &pixelAt, x0, y0, tileWidth](unsigned int tx, unsigned int ty) {
+        unsigned char& s = state[(unsigned long long int)ty * tileWidth + tx];
+        if (s & LOADED)
+            return pixelAt(tx, ty);
+
+        s |= LOADED;
+        return computePixel(job, x0 + tx, y0 + ty);
+    };
+
+    auto enqueue = [&state, &queue, tileWidth](unsigned int tx, unsigned int ty) {
+        unsigned int p = ty * tileWidth + tx;
+        if (state[p] & QUEUED)
+            return;
+
+        state[p] |= QUEUED;
+        queue.push_back(p);
+    };
+
+    // Seed with the tile edges, only contours reached from an edge are traced so the fill is a heuristic: an island of
+    // another colour inside the tile that no traced contour touches is filled with its surroundings' colour
+    // Connectedness makes these rare for the Mandelbrot set, but Tricorn and Burning Ship views can lose a few pixels
+    for (unsigned int tx = 0; tx < tileWidth; tx++) {
+        enqueue(tx, 0);
+        enqueue(tx, tileHeight - 1);
+    }
+
+    for (unsigned int ty = 0; ty < tileHeight; ty++) {
+        enqueue(0, ty);
+        enqueue(tileWidth - 1, ty);
+    }
+
+    while (!queue.empty()) {
+        if (cancelRender)
+            return;
+
+        unsigned int p = queue.back();
+        queue.pop_back();
+
+        unsigned int tx = p % tileWidth;
+        unsigned int ty = p / tileWidth;
+        unsigned int centre = load(tx, ty);
+
+        bool hasLeft = tx > 0, hasRight = tx + 1 < tileWidth;
+        bool hasUp = ty > 0, hasDown = ty + 1 < tileHeight;
+
+        // Neighbours across a colour change lie on a contour and are traced next
+        bool left = hasLeft && load(tx - 1, ty) != centre;
+        bool right = hasRight && load(tx + 1, ty) != centre;
+        bool up = hasUp && load(tx, ty - 1) != centre;
+        bool down = hasDown && load(tx, ty + 1) != centre;
+
+        if (left) enqueue(tx - 1, ty);
+        if (right) enqueue(tx + 1, ty);
+        if (up) enqueue(tx, ty - 1);
+        if (down) enqueue(tx, ty + 1);
+
+        // Follow contours that turn a corner
+        if (hasUp && hasLeft && (up || left)) enqueue(tx - 1, ty - 1);
+        if (hasUp && hasRight && (up || right)) enqueue(tx + 1, ty - 1);
+        if (hasDown && hasLeft && (down || left)) enqueue(tx - 1, ty + 1);
+        if (hasDown && hasRight && (down || right)) enqueue(tx + 1, ty + 1);
+    }
+
+    // Everything not computed is taken to be enclosed by a single colour, the left edge is always computed
+    for (unsigned int ty = 0; ty < tileHeight && !cancelRender; ty++) {
+        for (unsigned int tx = 1; tx < tileWidth; tx++) {
+            if (!(state[(unsigned long long int)ty * tileWidth + tx] & LOADED) && !isPixelKnown(job, x0 + tx, y0 + ty)) {
+                if (job.smoothFills && pixelAt(tx - 1, ty) < job.maxIterations) {
+                    computePixel(job, x0 + tx, y0 + ty);
+                    continue;
+                }
+
+                unsigned long long int index = (unsigned long long int)(y0 + ty) * job.width + x0 + tx;
+                pixelAt(tx, ty) = pixelAt(tx - 1, ty);
+                pixelFractionBuffer[index] = pixelFractionBuffer[index - 1];
+                pixelFlags[index] = PIXEL_FILLED;
+            }
+        }
+    }
+}
+
+// Shade by distance to the boundary, a pixel at distance d proves the disc of radius d / 4 around it is outside the set
+// (Koebe 1/4 theorem) so pixels in that disc far enough from the boundary are filled without iterating
+void FractalRenderer::renderDistanceEstimation(const renderJob& job) {
+    unsigned int tilesX = (job.width + DISTANCE_TILE_SIZE - 1) / DISTANCE_TILE_SIZE;
+    unsigned int tilesY = (job.height + DISTANCE_TILE_SIZE - 1) / DISTANCE_TILE_SIZE;
+
+    unsigned int exteriorSample = distanceSample(DISTANCE_SHADE_WIDTH);
+
+    bool completed = parallelFor(tilesX * tilesY, [this, &job, tilesX, exteriorSample](unsigned int i) {
+        unsigned int x0 = (i % tilesX) * DISTANCE_TILE_SIZE;
+        unsigned int y0 = (i / tilesX) * DISTANCE_TILE_SIZE;
+        unsigned int x1 = std::min(x0 + DISTANCE_TILE_SIZE, job.width);
+        unsigned int y1 = std::min(y0 + DISTANCE_TILE_SIZE, job.height);
+
+        // Discs are only filled within the tile so tiles never write each other's pixels
+        std::vector<bool> filled((unsigned long long int)(x1 - x0) * (y1 - y0), false);
+
+        auto pixelPosition = [&job](unsigned int x, unsigned int y) {
+            return screenToFractal(x / job.lengthScaleFactor, y / job.lengthScaleFactor, job.halfWinWidth, job.halfWinHeight, job.fractalWidthRatio, job.fractalHeightRatio, job.offsetX, job.offsetY);
+        };
+
+        for (unsigned int y = y0; y < y1; y++) {
+            for (unsigned int x = x0; x < x1; x++) {
+                if (cancelRender)
+                    return;
+
+                if (filled[(unsigned long long int)(y - y0) * (x1 - x0) + x - x0] || isPixelKnown(job, x, y))
+                    continue;
+
+                Complex c = pixelPosition(x, y);
+                long double distance = job.distanceFunc(c, job.maxIterations, job.pixelSpacing);
+
+                pixelDataBuffer[(unsigned long long int)y * job.width + x] = distanceSample(distance / job.pixelSpacing);
+                pixelFlags[(unsigned long long int)y * job.width + x] |= PIXEL_COMPUTED;
+
+                // Every point closer than this to c is at least the shading width away from the boundary
+                long double fillRadius = distance / 4.0 - DISTANCE_SHADE_WIDTH * job.pixelSpacing;
+                if (fillRadius <= job.pixelSpacing)
+                    continue;
+
+                unsigned int reach = (unsigned int)std::min<long double>(fillRadius / job.pixelSpacing + 1.0, DISTANCE_TILE_SIZE);
+                unsigned int fillX0 = x > x0 + reach ? x - reach : x0;
+                unsigned int fillY0 = y > y0 + reach ? y - reach : y0;
+                unsigned int fillX1 = std::min(x + reach + 1, x1);
+                unsigned int fillY1 = std::min(y + reach + 1, y1);
+
+                for (unsigned int fy = fillY0; fy < fillY1; fy++) {
+                    for (unsigned int fx = fillX0; fx < fillX1; fx++) {
+                        if (Complex::magSq(pixelPosition(fx, fy) - c) >= fillRadius * fillRadius)
+                            continue;
+
+                        filled[(unsigned long long int)(fy - y0) * (x1 - x0) + fx - x0] = true;
+                        pixelDataBuffer[(unsigned long long int)fy * job.width + fx] = exteriorSample;
+                    }
+                }
+            }
+        }
+
+        renderProgress++;
+    }, renderCancelled);
+    if (!completed)
+        return;
+
+    publishPixelData(job, 1, 1);
+}
+
+// Iterate each tile's region of c with interval arithmetic, tiles with a provable colour are filled exactly
+// and the rest are split until they are small enough to compute pixel by pixel
+void FractalRenderer::renderCertifiedTiles(const renderJob& job) {
+    unsigned int tilesX = (job.width + CERTIFIED_TILE_SIZE - 1) / CERTIFIED_TILE_SIZE;
+    unsigned int tilesY = (job.height + CERTIFIED_TILE_SIZE - 1) / CERTIFIED_TILE_SIZE;
+
+    bool completed = parallelFor(tilesX * tilesY, [this, &job, tilesX](unsigned int i) {
+        unsigned int x0 = (i % tilesX) * CERTIFIED_TILE_SIZE;
+        unsigned int y0 = (i / tilesX) * CERTIFIED_TILE_SIZE;
+
+        certifyTile(job, x0, y0, std::min(x0 + CERTIFIED_TILE_SIZE, job.width), std::min(y0 + CERTIFIED_TILE_SIZE, job.height));
+        renderProgress++;
+    }, renderCancelled);
+    if (!completed)
+        return;
+
+    publishPixelData(job, 1, 1);
+}
+
+// Certify or split the tile spanning x0..x1 and y0..y1 exclusive
+void FractalRenderer::certifyTile(const renderJob& job, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1) {
+    if (cancelRender || x0 >= x1 || y0 >= y1)
+        return;
+
+    // Tiles reused from a previous frame need no classifying
+    bool allKnown = !job.knownPixels.empty();
+    for (unsigned int y = y0; y < y1 && allKnown; y++)
+        for (unsigned int x = x0; x < x1 && allKnown; x++)
+            allKnown = isPixelKnown(job, x, y);
+
+    if (allKnown)
+        return;
+
+    // Rectangle covering every pixel position in the tile, screen y runs opposite to the imaginary axis
+    Complex topLeft = screenToFractal(x0 / job.lengthScaleFactor, y0 / job.lengthScaleFactor, job.halfWinWidth, job.halfWinHeight, job.fractalWidthRatio, job.fractalHeightRatio, job.offsetX, job.offsetY);
+    Complex bottomRight = screenToFractal((x1 - 1) / job.lengthScaleFactor, (y1 - 1) / job.lengthScaleFactor, job.halfWinWidth, job.halfWinHeight, job.fractalWidthRatio, job.fractalHeightRatio, job.offsetX, job.offsetY);
+    long double margin = job.pixelSpacing * CERTIFIED_TILE_MARGIN;
+
+    ComplexInterval region = ComplexInterval(
+        Interval(topLeft.real() - margin, bottomRight.real() + margin),
+        Interval(bottomRight.imag() - margin, topLeft.imag() + margin)
+    );
+
+    std::optional<unsigned int> tileSample = job.tileFunc(region, job.maxIterations);
+
+    if (tileSample && !(job.smoothFills && *tileSample < job.maxIterations)) {
+        // The escape is only known to the whole iteration, reused pixels keep their escape fractions and orbits
+        for (unsigned int y = y0; y < y1; y++) {
+            for (unsigned int x = x0; x < x1; x++) {
+                if (isPixelKnown(job, x, y))
+                    continue;
+
+                unsigned long long int index = (unsigned long long int)y * job.width + x;
+                pixelDataBuffer[index] = *tileSample;
+                pixelFractionBuffer[index] = 0;
+                pixelFlags[index] = PIXEL_FILLED;
+            }
+        }
+
+        return;
+    }
+
+    if (x1 - x0 <= CERTIFIED_MIN_TILE_SIZE || y1 - y0 <= CERTIFIED_MIN_TILE_SIZE) {
+        for (unsigned int y = y0; y < y1 && !cancelRender; y++)
+            for (unsigned int x = x0; x < x1; x++)
+                computePixel(job, x, y);
+
+        return;
+    }
+
+    unsigned int midX = (x0 + x1) / 2;
+    unsigned int midY = (y0 + y1) / 2;
+
+    certifyTile(job, x0, y0, midX, midY);
+    certifyTile(job, midX, y0, x1, midY);
+    certifyTile(job, x0, midY, midX, y1);
+    certifyTile(job, midX, midY, x1, y1);
+}
+
+// Escape fraction of a kernel's sample in 1/256ths, samples that didn't escape have none
+static unsigned char escapeFractionByte(unsigned int sample, const orbitState& orbit, unsigned int maxIterations) {
+    return sample < maxIterations ? (unsigned char)(orbit.escapeFraction * 255.0f) : 0;
+}
+
+// Supersample only the pixels on edges, where neighbouring samples differ enough to alias
+// Pixels are ranked by how strongly they differ, so when there are more than the budget allows the strongest edges are kept
+void FractalRenderer::renderAntiAliasing(const renderJob& job) {
+    auto contrast = [&job](unsigned int a, unsigned int b) -> unsigned int {
+        // Other samples, like Newton roots, are either the same or entirely different
+        if (!job.escapeTime)
+            return a == b ? 0 : job.maxIterations;
+
+        bool escapedA = a < job.maxIterations;
+        bool escapedB = b < job.maxIterations;
+        if (escapedA != escapedB)
+            return job.maxIterations;
+
+        if (!escapedA)
+            return 0;
+
+        return a > b ? a - b : b - a;
+    };
+
+    std::vector<unsigned int> edges(pixelDataBuffer.size(), 0);
+
+    bool completed = parallelFor(job.height, [this, &job, &contrast, &edges](unsigned int y) {
+        for (unsigned int x = 0; x < job.width; x++) {
+            unsigned long long int index = (unsigned long long int)y * job.width + x;
+            unsigned int sample = pixelDataBuffer[index];
+            unsigned int strongest = 0;
+
+            if (x > 0) strongest = std::max(strongest, contrast(sample, pixelDataBuffer[index - 1]));
+            if (x + 1 < job.width) strongest = std::max(strongest, contrast(sample, pixelDataBuffer[index + 1]));
+            if (y > 0) strongest = std::max(strongest, contrast(sample, pixelDataBuffer[index - job.width]));
+            if (y + 1 < job.height) strongest = std::max(strongest, contrast(sample, pixelDataBuffer[index + job.width]));
+
+            edges[index] = strongest;
+        }
+    }, renderCancelled);
+    if (!completed)
+        return;
+
+    std::vector<unsigned long long int> pixels;
+    for (unsigned long long int i = 0; i < edges.size(); i++) {
+        if (edges[i] >= ANTI_ALIAS_EDGE_ITERATIONS)
+            pixels.push_back(i);
+    }
+
+    if (pixels.empty())
+        return;
+
+    unsigned int samplesPerPixel = job.antiAliasGrid * job.antiAliasGrid;
+    unsigned long long int maxPixels = (unsigned long long int)(pixelDataBuffer.size() * job.antiAliasBudget / samplesPerPixel);
+
+    if (pixels.size() > maxPixels) {
+        std::nth_element(pixels.begin(), pixels.begin() + maxPixels, pixels.end(), [&edges](unsigned long long int a, unsigned long long int b) {
+            return edges[a] > edges[b];
+        });
+        pixels.resize(maxPixels);
+    }
+
+    subsampleTable table;
+    table.grid = job.antiAliasGrid;
+    table.samples.resize(pixels.size() * samplesPerPixel);
+    table.fractions.resize(pixels.size() * samplesPerPixel);
+
+    long double spacingY = job.fractalHeightRatio / job.lengthScaleFactor;
+
+    // Subsamples sit in a grid centred on the pixel's own sample, a pixel apart from the neighbouring pixels' grids
+    completed = parallelFor(pixels.size(), [this, &job, &pixels, &table, samplesPerPixel, spacingY](unsigned int i) {
+        unsigned int x = pixels[i] % job.width;
+        unsigned int y = pixels[i] / job.width;
+        Complex centre = screenToFractal(x / job.lengthScaleFactor, y / job.lengthScaleFactor, job.halfWinWidth, job.halfWinHeight, job.fractalWidthRatio, job.fractalHeightRatio, job.offsetX, job.offsetY);
+
+        for (unsigned int k = 0; k < samplesPerPixel; k++) {
+            long double dx = ((k % job.antiAliasGrid) + 0.5) / job.antiAliasGrid - 0.5;
+            long double dy = ((k / job.antiAliasGrid) + 0.5) / job.antiAliasGrid - 0.5;
+            Complex c = Complex(centre.real() + dx * job.pixelSpacing, centre.imag() - dy * spacingY);
+
+            orbitState orbit = {};
+            unsigned int sample = job.fractalFunc(c, job.maxIterations, job.pixelSpacing / job.antiAliasGrid, orbit);
+
+            table.samples[(unsigned long long int)i * samplesPerPixel + k] = sample;
+            table.fractions[(unsigned long long int)i * samplesPerPixel + k] = escapeFractionByte(sample, orbit, job.maxIterations);
+        }
+    }, renderCancelled);
+    if (!completed)
+        return;
+
+    table.pixels = std::move(pixels);
+    subsamples = std::move(table);
+
+    publishPixelData(job, 1, 1);
+}
+
+// Compute every pixel on the given lattice, returns false if the render was cancelled
+bool FractalRenderer::renderPixels(const renderJob& job, unsigned int startX, unsigned int startY, unsigned int stepX, unsigned int stepY) {
+    unsigned int numColumns = job.width > startX ? (job.width - startX + stepX - 1) / stepX : 0;
+
+    // Rows are only copied from a mirror row that is also on this lattice
+    auto mirrorSource = [&job, startY, stepY](unsigned int y) {
+        if (job.mirrorRows.empty())
+            return -1;
+
+        int source = job.mirrorRows[y];
+        return source >= (int)startY && (source - startY) % stepY == 0 ? source : -1;
+    };
+
+    return parallelFor(numColumns, [this, &job, startX, startY, stepX, stepY, &mirrorSource](unsigned int i) {
+        unsigned int x = startX + i * stepX;
+        std::unordered_map<unsigned int, orbitState> columnOrbits; // Unfinished orbits computed in this column, by row
+
+        for (unsigned int y = startY; y < job.height; y += stepY) {
+            if (cancelRender)
+                return;
+
+            if (mirrorSource(y) < 0) {
+                orbitState orbit = {};
+                if (computePixel(job, x, y, &orbit) == SAMPLE_UNFINISHED && orbit.iteration > 0)
+                    columnOrbits.emplace(y, orbit);
+            }
+        }
+
+        std::vector<std::pair<unsigned long long int, orbitState>> mirroredOrbits;
+
+        for (unsigned int y = startY; y < job.height; y += stepY) {
+            int source = mirrorSource(y);
+            if (source < 0 || isPixelKnown(job, x, y))
+                continue;
+
+            unsigned long long int index = (unsigned long long int)y * job.width + x;
+            unsigned long long int sourceIndex = (unsigned long long int)source * job.width + x;
+
+            // Unfinished pixels carry on from the mirrored orbit when the limit is raised, without one they are computed
+            if (pixelDataBuffer[sourceIndex] == SAMPLE_UNFINISHED && !(pixelFlags[sourceIndex] & PIXEL_FILLED)) {
+                auto orbit = columnOrbits.find(source);
+                if (orbit == columnOrbits.end()) {
+                    computePixel(job, x, y);
+                    continue;
+                }
+
+                mirroredOrbits.emplace_back(index, conjugateOrbit(orbit->second));
+            }
+
+            // Mirrored orbits are conjugates, so escape with the same magnitude
+            pixelDataBuffer[index] = job.mirrorSample(pixelDataBuffer[sourceIndex]);
+            pixelFractionBuffer[index] = pixelFractionBuffer[sourceIndex];
+            pixelFlags[index] = pixelFlags[sourceIndex] & PIXEL_FILLED;
+        }
+
+        if (!mirroredOrbits.empty()) {
+            std::lock_guard<std::mutex> lock(orbitMutex);
+            unfinishedOrbits.insert(unfinishedOrbits.end(), mirroredOrbits.begin(), mirroredOrbits.end());
+        }
+
+        renderProgress++;
+    }, renderCancelled);
+}
+
+// Predicted cost of filling in the tile spanning x0..x1 and y0..y1 inclusive, from its already computed border
+// A border of one sample encloses nothing to compute, otherwise the iterations along it stand in for those inside
+unsigned long long int FractalRenderer::tileBorderCost(const renderJob& job, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1) {
+    unsigned int borderValue = pixelDataBuffer[(unsigned long long int)y0 * job.width + x0];
+    unsigned long long int cost = 0;
+    bool uniform = true;
+
+    auto addPixel = [this, &job, &cost, &uniform, borderValue](unsigned int x, unsigned int y) {
+        unsigned int sample = pixelDataBuffer[(unsigned long long int)y * job.width + x];
+        uniform = uniform && sample == borderValue;
+        cost += std::min(sample, job.maxIterations); // Samples that never escaped ran to the limit or a detected cycle
+    };
+
+    for (unsigned int x = x0; x <= x1; x++) {
+        addPixel(x, y0);
+        addPixel(x, y1);
+    }
+
+    for (unsigned int y = y0; y <= y1; y++) {
+        addPixel(x0, y);
+        addPixel(x1, y);
+    }
+
+    return uniform ? 0 : cost;
+}
+
+// unfinishedOrbit, if given, receives the orbit of a pixel computed here that reached the limit
+unsigned int FractalRenderer::computePixel(const renderJob& job, unsigned int x, unsigned int y, orbitState* unfinishedOrbit) {
+    unsigned long long int index = (unsigned long long int)y * job.width + x;
+
+    // Pixels computed earlier in this render, like tile edges computed to schedule the tiles, are never computed twice
+    if (isPixelKnown(job, x, y) || (pixelFlags[index] & PIXEL_COMPUTED))
+        return pixelDataBuffer[index];
+
+    Complex c = screenToFractal(x / job.lengthScaleFactor, y / job.lengthScaleFactor, job.halfWinWidth, job.halfWinHeight, job.fractalWidthRatio, job.fractalHeightRatio, job.offsetX, job.offsetY);
+
+    // Carry on from where a previous frame stopped at a lower limit
+    orbitState orbit = {};
+    if (!job.resumeOrbits.empty()) {
+        auto resumed = job.resumeOrbits.find(index);
+        if (resumed != job.resumeOrbits.end())
+            orbit = resumed->second;
+    }
+
+    unsigned int sample = job.fractalFunc(c, job.maxIterations, job.pixelSpacing, orbit);
+    if (sample == SAMPLE_UNFINISHED) {
+        std::lock_guard<std::mutex> lock(orbitMutex);
+        unfinishedOrbits.emplace_back(index, orbit);
+
+        if (unfinishedOrbit)
+            *unfinishedOrbit = orbit;
+    }
+
+    pixelDataBuffer[index] = sample;
+    pixelFractionBuffer[index] = escapeFractionByte(sample, orbit, job.maxIterations);
+    pixelFlags[index] |= PIXEL_COMPUTED;
+
+    return sample;
+}
+
+// Run func for every index below count across all hardware threads, returns false if cancelled before finishing
+bool parallelFor(unsigned int count, const std::function<void(unsigned int)>& func, const std::function<bool()>& cancelled) {
+    int numThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+
+    // Work is handed out one index at a time so threads on cheap regions don't sit idle
+    std::atomic<unsigned int> next = 0;
+
+    for (int i = 0; i < numThreads; ++i) {
+        threads.emplace_back(std::thread([count, &func, &cancelled, &next]() {
+            for (unsigned int i = next++; i < count && !cancelled(); i = next++)
+                func(i);
+        }));
+    }
+
+    // Wait for all threads to finish
+    for (auto& t : threads)
+        if (t.joinable())
+            t.join();
+
+    return !cancelled();
+}
@@ -0,0 +1,54 @@
+#include "sample_buffer.hpp"
+#include "../fractals/fractals.hpp"
+
+// The sentinels take the top 2 values in 16 bits
+const uint16_t NARROW_UNFINISHED = UINT16_MAX - 1;
+const uint16_t NARROW_INTERIOR = UINT16_MAX;
+
+// Constructors
+SampleBuffer::SampleBuffer() {}
+SampleBuffer::SampleBuffer(const std::vector<unsigned int>& samples, bool fitsNarrow) {
+    if (!fitsNarrow) {
+        wide.assign(samples.begin(), samples.end());
+        return;
+    }
+
+    narrow.resize(samples.size());
+    for (unsigned long long int i = 0; i < samples.size(); i++) {
+        unsigned int sample = samples[i];
+
+        if (sample == SAMPLE_UNFINISHED)
+            narrow[i] = NARROW_UNFINISHED;
+        else if (sample == SAMPLE_INTERIOR)
+            narrow[i] = NARROW_INTERIOR;
+        else
+            narrow[i] = (uint16_t)sample;
+    }
+}
+
+// Getters
+unsigned int SampleBuffer::operator[](unsigned long long int index) const {
+    if (narrow.empty())
+        return wide[index];
+
+    uint16_t sample = narrow[index];
+    if (sample == NARROW_UNFINISHED)
+        return SAMPLE_UNFINISHED;
+    if (sample == NARROW_INTERIOR)
+        return SAMPLE_INTERIOR;
+
+    return sample;
+}
+
+unsigned long long int SampleBuffer::size() const {
+    return narrow.empty() ? wide.size() : narrow.size();
+}
+
+bool SampleBuffer::empty() const {
+    return size() == 0;
+}
+
+// Escape iterations are always below the limit, and root indices are tiny
+bool SampleBuffer::fitsNarrow(unsigned int maxIterations) {
+    return maxIterations <= NARROW_UNFINISHED;
+}
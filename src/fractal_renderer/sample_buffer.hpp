@@ -0,0 +1,26 @@
+#ifndef SAMPLE_BUFFER_H
+#define SAMPLE_BUFFER_H
+
+#include <cstdint>
+#include <vector>
+
+// Per-pixel samples of a finished frame, stored in 16 bits when every sample fits and 32 bits otherwise
+class SampleBuffer {
+    private:
+        std::vector<uint16_t> narrow;
+        std::vector<uint32_t> wide;
+
+    public:
+        // Constructors
+        SampleBuffer();
+        SampleBuffer(const std::vector<unsigned int>& samples, bool fitsNarrow);
+
+        // Getters
+        unsigned int operator[](unsigned long long int index) const;
+        unsigned long long int size() const;
+        bool empty() const;
+
+        static bool fitsNarrow(unsigned int maxIterations);
+};
+
+#endif
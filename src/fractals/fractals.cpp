@@ -1,10 +1,13 @@
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include "fractals.hpp"
+#include "interior_components.hpp"
 
-const unsigned int PERIODICITY_ITERATION = 20;
-const float PERIODICITY_EPSILON = 1e-8;
+const long double PERIODICITY_EPSILON_SCALE = 1e-3; // Fraction of a pixel the orbit must return within
+const long double DISTANCE_ESCAPE_RADIUS_SQ = 1e8;
+const unsigned int SMOOTH_EXTRA_ITERATIONS = 3; // Iterations past the escape before measuring |z|, each one shrinks the error from ignoring c
 
 const float NEWTON_FRACTAL_EPSILON = 1e-6;
 const Complex NEWTON_FRACTAL_ROOTS[3] = {
@@ -17,6 +20,7 @@ const colour NEWTON_FRACTAL_COLOURS[3] = {
     colour{ 0, 255, 0 },
     colour{ 0, 0, 255 },
 };
+const unsigned int NEWTON_FRACTAL_CONJUGATE_ROOTS[3] = { 0, 2, 1 }; // Index of the conjugate of each root
 
 Complex screenToFractal(
     unsigned int px, unsigned int py,
@@ -46,50 +50,230 @@ int calculateIterations(unsigned int numZooms, unsigned int initialIterations, u
     return std::clamp<unsigned int>(numZooms * iterationIncrement + initialIterations, 1, maxIterations);
 }
 
-bool checkPeriodicity(const Complex& z, const Complex& prevZ) {
-    long double deltaMagSq = Complex::magSq(z - prevZ);
+periodicityCheck beginPeriodicityCheck(long double pixelSpacing) {
+    long double epsilon = pixelSpacing * PERIODICITY_EPSILON_SCALE;
+    return periodicityCheck{ Complex(), 1, 1, epsilon * epsilon };
+}
+
+// Check if z has returned to the saved point
+bool checkPeriodicity(const periodicityCheck& check, const Complex& z) {
+    return Complex::magSq(z - check.savedZ) < check.epsilonSq;
+}
+
+// Brent's method, the saved point is replaced at doubling intervals so a cycle of any period is caught
+// Returns true when z became the new saved point
+bool updatePeriodicity(periodicityCheck& check, const Complex& z, unsigned int iteration) {
+    if (iteration < check.saveIteration)
+        return false;
+
+    check.savedZ = z;
+    check.saveInterval *= 2;
+    check.saveIteration += check.saveInterval;
+    return true;
+}
+
+orbitState beginOrbit(const Complex& z, long double pixelSpacing) {
+    return orbitState{ z, Complex(1.0), 1.0, beginPeriodicityCheck(pixelSpacing), 0, 0.0f };
+}
+
+// Orbit of the conjugate point, for the fractals whose maps commute with conjugation
+orbitState conjugateOrbit(const orbitState& orbit) {
+    orbitState mirrored = orbit;
+    mirrored.z = Complex::conj(orbit.z);
+    mirrored.dz = Complex::conj(orbit.dz);
+    mirrored.period.savedZ = Complex::conj(orbit.period.savedZ);
+    return mirrored;
+}
+
+// log2 from the exponent bits plus a quadratic fit of the mantissa, within 0.005 and branch free
+static float fastLog2(float x) {
+    unsigned int bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    float exponent = (float)((int)(bits >> 23) - 128); // The fit gives log2 of the mantissa plus one
 
-    // Approximate the angle difference
-    long double dot = z.real() * prevZ.real() + z.imag() * prevZ.imag();
-    long double cross = z.real() * prevZ.imag() - z.imag() * prevZ.real();
+    bits = (bits & 0x007FFFFF) | 0x3F800000; // Mantissa as a float in [1, 2)
+    float mantissa;
+    std::memcpy(&mantissa, &bits, sizeof(mantissa));
 
-    // Check if the magnitude and the angle are nearly the same
-    return deltaMagSq < PERIODICITY_EPSILON && fabs(dot - 1) < PERIODICITY_EPSILON && fabs(cross) < PERIODICITY_EPSILON;
+    return exponent + (-0.34484843f * mantissa + 2.02466578f) * mantissa - 0.67487759f;
 }
 
-colour processMandelbrot(Complex c, unsigned int maxIterations) {
+// Fractional part of the normalised iteration count n + 1 - log2(log2|z|) for degree 2 maps, from the first z past the escape radius
+template <typename Step>
+static float escapeFraction(Complex z, const Complex& c, Step step) {
+    for (unsigned int i = 0; i < SMOOTH_EXTRA_ITERATIONS; i++)
+        z = step(z, c);
+
+    // log2|z| is half of log2|z|^2, and doubles with every extra iteration
+    float fraction = 1.0f + SMOOTH_EXTRA_ITERATIONS - fastLog2(fastLog2((float)Complex::magSq(z)) * 0.5f);
+    return std::clamp(fraction, 0.0f, 1.0f);
+}
+
+// Check if c is inside a Mandelbrot component that is known without iterating
+bool insideMandelbrotInterior(const Complex& c) {
     // Check if inside main cardioid
     long double reMinusQuarter = c.real() - 0.25;
     long double imSquared = c.imag() * c.imag();
     long double q = reMinusQuarter * reMinusQuarter + imSquared;
     if (q * (q + reMinusQuarter) <= 0.25 * imSquared)
-        return BLACK;
+        return true;
 
     // Check if inside period-2 bulb
     long double rePlusOne = c.real() + 1.0;
     if (rePlusOne * rePlusOne + imSquared <= 0.0625)
+        return true;
+
+    // Check if inside one of the larger higher-period components
+    return insideInteriorComponent(c);
+}
+
+// Check if every c in the rectangle is inside a known component, interval bounds make the test conservative
+bool insideMandelbrotInterior(const ComplexInterval& c) {
+    Interval reMinusQuarter = c.real() - Interval(0.25);
+    Interval imSquared = Interval::sqr(c.imag());
+    Interval q = Interval::sqr(reMinusQuarter) + imSquared;
+    if ((q * (q + reMinusQuarter) - Interval(0.25) * imSquared).upper() <= 0.0)
+        return true;
+
+    Interval rePlusOne = c.real() + Interval(1.0);
+    if ((Interval::sqr(rePlusOne) + imSquared).upper() <= 0.0625)
+        return true;
+
+    return insideInteriorComponent(c);
+}
+
+// Iterate a whole rectangle of c values at once, giving the sample every point in it is certain to have
+// Empty if the points could end up with different samples
+template <typename Step>
+std::optional<unsigned int> classifyTile(const ComplexInterval& c, unsigned int maxIterations, Step step) {
+    ComplexInterval z = ComplexInterval(); // z_0 = 0
+
+    // Saved at doubling intervals like the per-pixel periodicity check
+    ComplexInterval savedZ = z;
+    unsigned int saveIteration = 1;
+    unsigned int saveInterval = 1;
+
+    for (unsigned int i = 0; i < maxIterations; i++) {
+        z = step(z, c);
+
+        Interval magSq = ComplexInterval::magSq(z);
+        if (magSq.lower() > 4.0)
+            return i; // Every point escapes on this iteration
+        if (magSq.upper() > 4.0)
+            return std::nullopt; // Some points escape on this iteration and some don't
+
+        // Interval steps preserve containment, so once z falls inside an earlier rectangle every later
+        // rectangle repeats inside the ones already checked and no point can ever escape
+        if (ComplexInterval::contains(savedZ, z))
+            return SAMPLE_INTERIOR;
+
+        if (i >= saveIteration) {
+            savedZ = z;
+            saveInterval *= 2;
+            saveIteration += saveInterval;
+        }
+    }
+
+    // No point escapes before the limit
+    return SAMPLE_UNFINISHED;
+}
+
+// Fractals with the same sample at conjugate points
+unsigned int mirrorSameSample(unsigned int sample) {
+    return sample;
+}
+
+colour colourEscapeTime(unsigned int sample, unsigned int maxIterations, const colourScheme& scheme) {
+    if (sample >= maxIterations)
         return BLACK;
 
-    Complex z = Complex(); // z_0 = 0
-    Complex prevZ = z;
+    return colourGradient(sample, maxIterations, scheme);
+}
 
-    for (int i = 0; i < maxIterations; i++) {
-        z = z * z + c; // z_n+1 = z_n^2 + c
+unsigned int processMandelbrot(Complex c, unsigned int maxIterations, long double pixelSpacing, orbitState& orbit) {
+    if (orbitPastLimit(orbit, maxIterations))
+        return SAMPLE_UNFINISHED;
+
+    if (orbit.iteration == 0) {
+        if (insideMandelbrotInterior(c))
+            return SAMPLE_INTERIOR;
+
+        orbit = beginOrbit(Complex(), pixelSpacing); // z_0 = 0
+    }
+
+    Complex z = orbit.z;
+    Complex dz = orbit.dz; // Derivative of z with respect to the saved point
+    periodicityCheck period = orbit.period;
+
+    auto step = [](const Complex& z, const Complex& c) {
+        return z * z + c; // z_n+1 = z_n^2 + c
+    };
+
+    for (unsigned int i = orbit.iteration; i < maxIterations; i++) {
+        dz = z * dz * 2.0; // dz_n+1 = 2 * z_n * dz_n
+        z = step(z, c);
 
         // Escape condition
-        if (Complex::magSq(z) > 4.0)
-            return colourGradient(i, maxIterations);
+        if (Complex::magSq(z) > 4.0) {
+            orbit.escapeFraction = escapeFraction(z, c, step);
+            return i;
+        }
 
-        // Periodicity check
-        if (i % PERIODICITY_ITERATION == 0) {
-            if (checkPeriodicity(z, prevZ))
-                return BLACK;
+        // Returning to the saved point while contracting means the orbit has found an attracting cycle
+        if (checkPeriodicity(period, z) && Complex::magSq(dz) < 1.0)
+            return SAMPLE_INTERIOR;
+
+        if (updatePeriodicity(period, z, i))
+            dz = Complex(1.0);
+    }
+
+    orbit.z = z;
+    orbit.dz = dz;
+    orbit.period = period;
+    orbit.iteration = maxIterations;
+    return SAMPLE_UNFINISHED;
+}
+
+// Exterior distance estimate 2|z|log|z| / |dz/dc|, the true distance to the set is at least a quarter of this
+// Returns 0 for points that don't escape
+long double estimateDistanceMandelbrot(Complex c, unsigned int maxIterations, long double pixelSpacing) {
+    if (insideMandelbrotInterior(c))
+        return 0.0;
+
+    Complex z = Complex(); // z_0 = 0
+    Complex dc = Complex(); // Derivative of z with respect to c
+    Complex dz = Complex(1.0); // Derivative of z with respect to the saved point
+    periodicityCheck period = beginPeriodicityCheck(pixelSpacing);
 
-            prevZ = z;
+    for (unsigned int i = 0; i < maxIterations; i++) {
+        dc = z * dc * 2.0 + 1.0; // dc_n+1 = 2 * z_n * dc_n + 1
+        dz = z * dz * 2.0;
+        z = z * z + c;
+
+        // Escape condition, a large radius keeps the estimate accurate
+        long double magSq = Complex::magSq(z);
+        if (magSq > DISTANCE_ESCAPE_RADIUS_SQ) {
+            long double mag = sqrtl(magSq);
+            return 2.0 * mag * logl(mag) / Complex::mag(dc);
         }
+
+        if (checkPeriodicity(period, z) && Complex::magSq(dz) < 1.0)
+            return 0.0;
+
+        if (updatePeriodicity(period, z, i))
+            dz = Complex(1.0);
     }
 
-    return BLACK;
+    return 0.0;
+}
+
+std::optional<unsigned int> classifyMandelbrotTile(const ComplexInterval& c, unsigned int maxIterations) {
+    if (insideMandelbrotInterior(c))
+        return SAMPLE_INTERIOR;
+
+    return classifyTile(c, maxIterations, [](const ComplexInterval& z, const ComplexInterval& c) {
+        return ComplexInterval::sqr(z) + c;
+    });
 }
 
 std::vector<Complex> calcTrajectoryMandelbrot(Complex c, unsigned int maxIterations) {
@@ -107,28 +291,51 @@ std::vector<Complex> calcTrajectoryMandelbrot(Complex c, unsigned int maxIterati
     return trajectory;
 }
 
-colour processTricorn(Complex c, unsigned int maxIterations) {
-    Complex z = Complex(); // z_0 = 0
-    Complex prevZ = z;
+unsigned int processTricorn(Complex c, unsigned int maxIterations, long double pixelSpacing, orbitState& orbit) {
+    if (orbitPastLimit(orbit, maxIterations))
+        return SAMPLE_UNFINISHED;
 
-    for (int i = 0; i < maxIterations; i++) {
+    if (orbit.iteration == 0)
+        orbit = beginOrbit(Complex(), pixelSpacing); // z_0 = 0
+
+    Complex z = orbit.z;
+    long double dzMagSq = orbit.dzMagSq; // Squared magnitude of the derivative of z with respect to the saved point
+    periodicityCheck period = orbit.period;
+
+    auto step = [](const Complex& z, const Complex& c) {
         Complex zConj = Complex::conj(z);
-        z = zConj * zConj + c; // z_n+1 = Conj(z)_n^2 + c
+        return zConj * zConj + c; // z_n+1 = Conj(z)_n^2 + c
+    };
+
+    for (unsigned int i = orbit.iteration; i < maxIterations; i++) {
+        dzMagSq *= 4.0 * Complex::magSq(z); // |dz_n+1| = 2 * |z_n| * |dz_n|, conjugation preserves magnitude
+        z = step(z, c);
 
         // Escape condition
-        if (Complex::magSq(z) > 4.0)
-            return colourGradient(i, maxIterations);
+        if (Complex::magSq(z) > 4.0) {
+            orbit.escapeFraction = escapeFraction(z, c, step);
+            return i;
+        }
 
-        // Periodicity check
-        if (i % PERIODICITY_ITERATION == 0) {
-            if (checkPeriodicity(z, prevZ))
-                return BLACK;
+        // Returning to the saved point while contracting means the orbit has found an attracting cycle
+        if (checkPeriodicity(period, z) && dzMagSq < 1.0)
+            return SAMPLE_INTERIOR;
 
-            prevZ = z;
-        }
+        if (updatePeriodicity(period, z, i))
+            dzMagSq = 1.0;
     }
 
-    return BLACK;
+    orbit.z = z;
+    orbit.dzMagSq = dzMagSq;
+    orbit.period = period;
+    orbit.iteration = maxIterations;
+    return SAMPLE_UNFINISHED;
+}
+
+std::optional<unsigned int> classifyTricornTile(const ComplexInterval& c, unsigned int maxIterations) {
+    return classifyTile(c, maxIterations, [](const ComplexInterval& z, const ComplexInterval& c) {
+        return ComplexInterval::sqr(ComplexInterval::conj(z)) + c;
+    });
 }
 
 std::vector<Complex> calcTrajectoryTricorn(Complex c, unsigned int maxIterations) {
@@ -147,31 +354,50 @@ std::vector<Complex> calcTrajectoryTricorn(Complex c, unsigned int maxIterations
     return trajectory;
 }
 
-colour processBurningShip(Complex c, unsigned int maxIterations) {
-    Complex z = Complex(); // z_0 = 0
-    Complex prevZ = z;
+unsigned int processBurningShip(Complex c, unsigned int maxIterations, long double pixelSpacing, orbitState& orbit) {
+    if (orbitPastLimit(orbit, maxIterations))
+        return SAMPLE_UNFINISHED;
+
+    if (orbit.iteration == 0)
+        orbit = beginOrbit(Complex(), pixelSpacing); // z_0 = 0
+
+    Complex z = orbit.z;
+    periodicityCheck period = orbit.period;
 
     c = Complex::conj(c); // Reflect in real axis
 
-    for (int i = 0; i < maxIterations; i++) {
-        long double absReal = abs(z.real());
-        long double absImag = abs(z.imag());
-        z = Complex(absReal, absImag) * Complex(absReal, absImag) + c; // z_n+1 = (|Re(z_n)| + i|Im(z_n)|)^2 + c
+    auto step = [](const Complex& z, const Complex& c) {
+        long double absReal = std::abs(z.real());
+        long double absImag = std::abs(z.imag());
+        return Complex(absReal, absImag) * Complex(absReal, absImag) + c; // z_n+1 = (|Re(z_n)| + i|Im(z_n)|)^2 + c
+    };
+
+    for (unsigned int i = orbit.iteration; i < maxIterations; i++) {
+        z = step(z, c);
 
         // Escape condition
-        if (Complex::magSq(z) > 4.0)
-            return colourGradient(i, maxIterations);
+        if (Complex::magSq(z) > 4.0) {
+            orbit.escapeFraction = escapeFraction(z, c, step);
+            return i;
+        }
 
         // Periodicity check
-        if (i % PERIODICITY_ITERATION == 0) {
-            if (checkPeriodicity(z, prevZ))
-                return BLACK;
+        if (checkPeriodicity(period, z))
+            return SAMPLE_INTERIOR;
 
-            prevZ = z;
-        }
+        updatePeriodicity(period, z, i);
     }
 
-    return BLACK;
+    orbit.z = z;
+    orbit.period = period;
+    orbit.iteration = maxIterations;
+    return SAMPLE_UNFINISHED;
+}
+
+std::optional<unsigned int> classifyBurningShipTile(const ComplexInterval& c, unsigned int maxIterations) {
+    return classifyTile(ComplexInterval::conj(c), maxIterations, [](const ComplexInterval& z, const ComplexInterval& c) {
+        return ComplexInterval::sqr(ComplexInterval(Interval::abs(z.real()), Interval::abs(z.imag()))) + c;
+    });
 }
 
 std::vector<Complex> calcTrajectoryBurningShip(Complex c, unsigned int maxIterations) {
@@ -181,8 +407,8 @@ std::vector<Complex> calcTrajectoryBurningShip(Complex c, unsigned int maxIterat
     c = Complex::conj(c);
 
     for (int i = 0; i < maxIterations; i++) {
-        long double absReal = abs(z.real());
-        long double absImag = abs(z.imag());
+        long double absReal = std::abs(z.real());
+        long double absImag = std::abs(z.imag());
         z = Complex(absReal, absImag) * Complex(absReal, absImag) + c;
 
         trajectory.push_back(Complex::conj(z));
@@ -194,8 +420,17 @@ std::vector<Complex> calcTrajectoryBurningShip(Complex c, unsigned int maxIterat
     return trajectory;
 }
 
-colour processNewtonFractal(Complex z, unsigned int maxIterations) {
-    for (int i = 0; i < maxIterations; i++) {
+// Gives the index of the root z converges to
+unsigned int processNewtonFractal(Complex z, unsigned int maxIterations, long double pixelSpacing, orbitState& orbit) {
+    if (orbitPastLimit(orbit, maxIterations))
+        return SAMPLE_UNFINISHED;
+
+    if (orbit.iteration == 0)
+        orbit = beginOrbit(z, pixelSpacing);
+
+    z = orbit.z;
+
+    for (unsigned int i = orbit.iteration; i < maxIterations; i++) {
         Complex zSquared = z * z; // z^2
         Complex zCubed = zSquared * z; // z^3
         Complex fz = zCubed - 1.0; // f(z) = z^3 - 1
@@ -203,16 +438,27 @@ colour processNewtonFractal(Complex z, unsigned int maxIterations) {
 
         z -= fz / fzPrime; // z_n+1 = z_n - f(z) / f'(z)
 
-        // Assign colour based on which root z converges to
+        // Check which root z converges to
         for (int j = 0; j < 3; j++)
         {
             Complex diff = z - NEWTON_FRACTAL_ROOTS[j];
-            if (abs(diff.real()) < NEWTON_FRACTAL_EPSILON && abs(diff.imag()) < NEWTON_FRACTAL_EPSILON)
-                return NEWTON_FRACTAL_COLOURS[j];
+            if (std::abs(diff.real()) < NEWTON_FRACTAL_EPSILON && std::abs(diff.imag()) < NEWTON_FRACTAL_EPSILON)
+                return j;
         };
     }
 
-    return BLACK;
+    orbit.z = z;
+    orbit.iteration = maxIterations;
+    return SAMPLE_UNFINISHED;
+}
+
+colour colourNewtonFractal(unsigned int sample, unsigned int maxIterations, const colourScheme& scheme) {
+    return sample < 3 ? NEWTON_FRACTAL_COLOURS[sample] : BLACK;
+}
+
+// Conjugate points converge to conjugate roots
+unsigned int mirrorNewtonFractalSample(unsigned int sample) {
+    return sample < 3 ? NEWTON_FRACTAL_CONJUGATE_ROOTS[sample] : sample;
 }
 
 std::vector<Complex> calcTrajectoryNewtonFractal(Complex z, unsigned int maxIterations) {
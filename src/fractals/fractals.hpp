@@ -1,10 +1,13 @@
 #ifndef FRACTALS_H
 #define FRACTALS_H
 
+#include <climits>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "../complex/complex.hpp"
+#include "../complex/complex_interval.hpp"
 #include "../colour/colour.hpp"
 
 Complex screenToFractal(
@@ -21,19 +24,65 @@ std::pair<unsigned int, unsigned int> fractalToScreen(
 	long double offsetX, long double offsetY
 );
 
+// Kernels give a sample for each point, the escape iteration or root index, or one of these
+const unsigned int SAMPLE_UNFINISHED = UINT_MAX - 1; // Still iterating when the limit was reached
+const unsigned int SAMPLE_INTERIOR = UINT_MAX; // Never escapes
+
+// Cycle detection state shared by the escape-time fractals
+struct periodicityCheck {
+	Complex savedZ;
+	unsigned int saveIteration;
+	unsigned int saveInterval;
+	long double epsilonSq;
+};
+
+// Where an orbit had got to when it reached the iteration limit, so it can carry on if the limit is raised
+// A zero iteration starts a new orbit
+struct orbitState {
+	Complex z;
+	Complex dz;
+	long double dzMagSq;
+	periodicityCheck period;
+	unsigned int iteration;
+	float escapeFraction; // Set on escape, how far through the escape iteration the orbit crossed the escape radius, for smooth colouring
+};
+
+// An orbit resumed from a higher limit has already iterated past this one, so it can't be labelled with a lower
+// escape iteration and stays unfinished
+inline bool orbitPastLimit(const orbitState& orbit, unsigned int maxIterations) {
+	return orbit.iteration >= maxIterations;
+}
+
 int calculateIterations(unsigned int numZooms, unsigned int initialIterations, unsigned int iterationIncrement, unsigned int maxIterations);
-bool checkPeriodicity(const Complex& z, const Complex& prevZ);
 
-colour processMandelbrot(Complex c, unsigned int maxIterations);
+periodicityCheck beginPeriodicityCheck(long double pixelSpacing);
+bool checkPeriodicity(const periodicityCheck& check, const Complex& z);
+bool updatePeriodicity(periodicityCheck& check, const Complex& z, unsigned int iteration);
+orbitState beginOrbit(const Complex& z, long double pixelSpacing);
+orbitState conjugateOrbit(const orbitState& orbit);
+
+bool insideMandelbrotInterior(const Complex& c);
+bool insideMandelbrotInterior(const ComplexInterval& c);
+
+unsigned int mirrorSameSample(unsigned int sample);
+colour colourEscapeTime(unsigned int sample, unsigned int maxIterations, const colourScheme& scheme);
+
+unsigned int processMandelbrot(Complex c, unsigned int maxIterations, long double pixelSpacing, orbitState& orbit);
+long double estimateDistanceMandelbrot(Complex c, unsigned int maxIterations, long double pixelSpacing);
+std::optional<unsigned int> classifyMandelbrotTile(const ComplexInterval& c, unsigned int maxIterations);
 std::vector<Complex> calcTrajectoryMandelbrot(Complex c, unsigned int maxIterations);
 
-colour processTricorn(Complex c, unsigned int maxIterations);
+unsigned int processTricorn(Complex c, unsigned int maxIterations, long double pixelSpacing, orbitState& orbit);
+std::optional<unsigned int> classifyTricornTile(const ComplexInterval& c, unsigned int maxIterations);
 std::vector<Complex> calcTrajectoryTricorn(Complex c, unsigned int maxIterations);
 
-colour processBurningShip(Complex c, unsigned int maxIterations);
+unsigned int processBurningShip(Complex c, unsigned int maxIterations, long double pixelSpacing, orbitState& orbit);
+std::optional<unsigned int> classifyBurningShipTile(const ComplexInterval& c, unsigned int maxIterations);
 std::vector<Complex> calcTrajectoryBurningShip(Complex c, unsigned int maxIterations);
 
-colour processNewtonFractal(Complex z, unsigned int maxIterations);
+unsigned int processNewtonFractal(Complex z, unsigned int maxIterations, long double pixelSpacing, orbitState& orbit);
+colour colourNewtonFractal(unsigned int sample, unsigned int maxIterations, const colourScheme& scheme);
+unsigned int mirrorNewtonFractalSample(unsigned int sample);
 std::vector<Complex> calcTrajectoryNewtonFractal(Complex z, unsigned int maxIterations);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cmath>
+
+#include "interior_components.hpp"
+
+// Largest period 3, 4 and 5 components and the largest satellites budding off them and the period-2 bulb
+// Radii are the distance from the nucleus to the traced component boundary, shrunk by 1%
+const std::vector<componentDisc> INTERIOR_COMPONENT_DISCS = {
+    { 3, Complex(-0.1225611668766536, 0.7448617666197442), 9.1220202510e-02 },
+    { 3, Complex(-0.1225611668766536, -0.7448617666197442), 9.1220202510e-02 },
+    { 3, Complex(-1.7548776662466927, 0.0), 4.8288895842e-03 },
+    { 4, Complex(-1.3107026413368330, 0.0), 5.6822335074e-02 },
+    { 4, Complex(0.2822713907669139, 0.5300606175785253), 4.2062383379e-02 },
+    { 4, Complex(0.2822713907669139, -0.5300606175785253), 4.2062383379e-02 },
+    { 4, Complex(-0.1565201668337551, 1.0322471089228318), 2.1379772126e-03 },
+    { 4, Complex(-0.1565201668337551, -1.0322471089228318), 2.1379772126e-03 },
+    { 4, Complex(-1.9407998065294847, 0.0), 2.4652737780e-04 },
+    { 5, Complex(-0.5043401754462440, 0.5627657614529820), 3.8053623040e-02 },
+    { 5, Complex(-0.5043401754462440, -0.5627657614529820), 3.8053623040e-02 },
+    { 5, Complex(0.3795135880159237, 0.3349323055974975), 2.2515134214e-02 },
+    { 5, Complex(0.3795135880159237, -0.3349323055974975), 2.2515134214e-02 },
+    { 5, Complex(0.3592592247580074, 0.6425137371385423), 1.1996347667e-03 },
+    { 5, Complex(0.3592592247580074, -0.6425137371385423), 1.1996347667e-03 },
+    { 5, Complex(-1.6254137251233038, 0.0), 1.0065685963e-03 },
+    { 5, Complex(-0.0442123577040706, 0.9865809762808928), 8.7096646534e-04 },
+    { 5, Complex(-0.0442123577040706, -0.9865809762808928), 8.7096646534e-04 },
+    { 5, Complex(-1.2563679300681807, 0.3803209634727224), 7.1700508034e-04 },
+    { 5, Complex(-1.2563679300681807, -0.3803209634727224), 7.1700508034e-04 },
+    { 5, Complex(-1.8607825222048548, 0.0), 1.9359353022e-04 },
+    { 5, Complex(-0.1980420993642538, 1.1002695372926985), 1.6988772242e-04 },
+    { 5, Complex(-0.1980420993642538, -1.1002695372926985), 1.6988772242e-04 },
+    { 6, Complex(-1.1380006666509646, 0.2403324012620985), 2.5408930245e-02 },
+    { 6, Complex(-1.1380006666509646, -0.2403324012620985), 2.5408930245e-02 },
+    { 6, Complex(-0.1134186559494365, 0.8605694725015732), 2.1663791734e-02 },
+    { 6, Complex(-0.1134186559494365, -0.8605694725015732), 2.1663791734e-02 },
+    { 6, Complex(-1.7728929033816236, 0.0), 4.2854288736e-03 },
+    { 6, Complex(-1.4760146427284300, 0.0), 1.3060722767e-03 },
+    { 6, Complex(0.4433256333996236, 0.3729624166628466), 7.4265029868e-04 },
+    { 6, Complex(0.4433256333996236, -0.3729624166628466), 7.4265029868e-04 },
+    { 8, Complex(-1.3815474844320617, 0.0), 1.2373685447e-02 },
+};
+
+const unsigned int COMPONENT_GRID_SIZE = 64;
+
+// Uniform grid over the bounding box of the discs, each cell lists the discs overlapping it
+struct componentGrid {
+    long double minReal;
+    long double minImag;
+    long double cellWidth;
+    long double cellHeight;
+    std::vector<std::vector<unsigned int>> cells;
+};
+
+static componentGrid buildComponentGrid() {
+    componentGrid grid;
+
+    long double minReal = INFINITY, maxReal = -INFINITY;
+    long double minImag = INFINITY, maxImag = -INFINITY;
+    for (const componentDisc& disc : INTERIOR_COMPONENT_DISCS) {
+        minReal = std::min(minReal, disc.nucleus.real() - disc.radius);
+        maxReal = std::max(maxReal, disc.nucleus.real() + disc.radius);
+        minImag = std::min(minImag, disc.nucleus.imag() - disc.radius);
+        maxImag = std::max(maxImag, disc.nucleus.imag() + disc.radius);
+    }
+
+    grid.minReal = minReal;
+    grid.minImag = minImag;
+    grid.cellWidth = (maxReal - minReal) / COMPONENT_GRID_SIZE;
+    grid.cellHeight = (maxImag - minImag) / COMPONENT_GRID_SIZE;
+    grid.cells.resize(COMPONENT_GRID_SIZE * COMPONENT_GRID_SIZE);
+
+    // Add each disc to every cell its bounding box touches
+    for (unsigned int i = 0; i < INTERIOR_COMPONENT_DISCS.size(); i++) {
+        const componentDisc& disc = INTERIOR_COMPONENT_DISCS[i];
+
+        auto cellIndex = [](long double value, long double min, long double size) {
+            return (unsigned int)std::clamp<long double>(std::floor((value - min) / size), 0, COMPONENT_GRID_SIZE - 1);
+        };
+
+        unsigned int x0 = cellIndex(disc.nucleus.real() - disc.radius, grid.minReal, grid.cellWidth);
+        unsigned int x1 = cellIndex(disc.nucleus.real() + disc.radius, grid.minReal, grid.cellWidth);
+        unsigned int y0 = cellIndex(disc.nucleus.imag() - disc.radius, grid.minImag, grid.cellHeight);
+        unsigned int y1 = cellIndex(disc.nucleus.imag() + disc.radius, grid.minImag, grid.cellHeight);
+
+        for (unsigned int y = y0; y <= y1; y++)
+            for (unsigned int x = x0; x <= x1; x++)
+                grid.cells[y * COMPONENT_GRID_SIZE + x].push_back(i);
+    }
+
+    return grid;
+}
+
+// Discs that may contain c, from the grid cell c falls in
+static const std::vector<unsigned int>& discsNear(const Complex& c) {
+    static const componentGrid grid = buildComponentGrid();
+    static const std::vector<unsigned int> none;
+
+    long double cellX = std::floor((c.real() - grid.minReal) / grid.cellWidth);
+    long double cellY = std::floor((c.imag() - grid.minImag) / grid.cellHeight);
+    if (cellX < 0 || cellY < 0 || cellX >= COMPONENT_GRID_SIZE || cellY >= COMPONENT_GRID_SIZE)
+        return none;
+
+    return grid.cells[(unsigned int)cellY * COMPONENT_GRID_SIZE + (unsigned int)cellX];
+}
+
+static bool insideDisc(const Complex& c, const componentDisc& disc) {
+    return Complex::magSq(c - disc.nucleus) <= disc.radius * disc.radius;
+}
+
+// Check if c lies in one of the tabulated components, so it can be coloured without iterating
+bool insideInteriorComponent(const Complex& c) {
+    for (unsigned int i : discsNear(c)) {
+        if (insideDisc(c, INTERIOR_COMPONENT_DISCS[i]))
+            return true;
+    }
+
+    return false;
+}
+
+// Check if the whole rectangle lies in one of the tabulated components, discs are convex so checking the corners is enough
+// A disc holding the rectangle holds every corner, so only the discs near one corner need checking
+bool insideInteriorComponent(const ComplexInterval& c) {
+    Complex corners[4] = {
+        Complex(c.real().lower(), c.imag().lower()),
+        Complex(c.real().lower(), c.imag().upper()),
+        Complex(c.real().upper(), c.imag().lower()),
+        Complex(c.real().upper(), c.imag().upper()),
+    };
+
+    for (unsigned int i : discsNear(corners[0])) {
+        bool inside = true;
+        for (const Complex& corner : corners)
+            inside = inside && insideDisc(corner, INTERIOR_COMPONENT_DISCS[i]);
+
+        if (inside)
+            return true;
+    }
+
+    return false;
+}
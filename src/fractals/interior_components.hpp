@@ -0,0 +1,19 @@
+#ifndef INTERIOR_COMPONENTS_H
+#define INTERIOR_COMPONENTS_H
+
+#include <vector>
+
+#include "../complex/complex.hpp"
+#include "../complex/complex_interval.hpp"
+
+// A disc centred on the nucleus of a Mandelbrot hyperbolic component, lying entirely inside the component
+struct componentDisc {
+	unsigned int period;
+	Complex nucleus;
+	long double radius;
+};
+
+bool insideInteriorComponent(const Complex& c);
+bool insideInteriorComponent(const ComplexInterval& c);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef ANTI_ALIAS_OPTION_H
+#define ANTI_ALIAS_OPTION_H
+
+#include <string>
+
+struct antiAliasOption {
+    std::string name;
+    unsigned int grid; // Subsamples along each side of a supersampled pixel, 0 for none
+};
+
+#endif
\ No newline at end of file
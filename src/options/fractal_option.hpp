@@ -4,13 +4,20 @@
 #include <SDL2/SDL.h>
 
 #include "../complex/complex.hpp"
+#include "../complex/complex_interval.hpp"
 #include "../colour/colour.hpp"
+#include "../fractals/fractals.hpp"
 
 struct fractalOption {
     std::string name;
     SDL_Keycode key;
-    std::function<colour(Complex, unsigned int)> func;
+    std::function<unsigned int(Complex, unsigned int, long double, orbitState&)> func;
+    std::function<colour(unsigned int, unsigned int, const colourScheme&)> colourFunc; // Colour of a sample from func at the given max iterations
     std::function<std::vector<Complex>(Complex, unsigned int)> trajectoryFunc;
+    bool escapeTime; // Samples are escape iterations, so regions bordered by one sample can be filled
+    std::function<long double(Complex, unsigned int, long double)> distanceFunc; // Empty if there is no distance estimate
+    std::function<std::optional<unsigned int>(const ComplexInterval&, unsigned int)> tileFunc; // Empty if tiles can't be certified
+    std::function<unsigned int(unsigned int)> mirrorSample; // Sample of the point mirrored in the real axis, empty if not symmetric
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,14 @@
+#ifndef PALETTE_OPTION_H
+#define PALETTE_OPTION_H
+
+#include <string>
+#include <vector>
+
+#include "../colour/colour.hpp"
+
+struct paletteOption {
+    std::string name;
+    std::vector<colour> stops; // The last stop should match the first so the gradient loops
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef RENDER_MODE_OPTION_H
+#define RENDER_MODE_OPTION_H
+
+#include <string>
+
+enum class renderMode {
+    STANDARD,
+    PROGRESSIVE,
+    SOLID_GUESSING,
+    BOUNDARY_TRACING,
+    DISTANCE_ESTIMATION,
+    CERTIFIED_TILES
+};
+
+struct renderModeOption {
+    std::string name;
+    renderMode mode;
+};
+
+#endif